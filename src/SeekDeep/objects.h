@@ -32,4 +32,10 @@
 #include "SeekDeep/objects/ControlBenchmarking.h"
 #include "SeekDeep/objects/TarAmpSetupUtils.h"
 #include "SeekDeep/objects/IlluminaUtils.h"
+#include "SeekDeep/objects/KmerUtils.h"
+#include "SeekDeep/objects/SeqIOUtils.h"
+#include "SeekDeep/objects/Instrumentation.h"
+#include "SeekDeep/objects/ClusteringUtils.h"
+#include "SeekDeep/objects/AlignmentUtils.h"
+#include "SeekDeep/objects/BatchUtils.h"
 
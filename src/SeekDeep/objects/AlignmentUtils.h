@@ -0,0 +1,13 @@
+#pragma once
+
+/*
+ * AlignmentUtils.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+
+
+#include "SeekDeep/objects/AlignmentUtils/AlnCacheStore.hpp"
+#include "SeekDeep/objects/AlignmentUtils/BandedEditDistance.hpp"
+
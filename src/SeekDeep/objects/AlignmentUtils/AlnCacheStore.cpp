@@ -0,0 +1,314 @@
+/*
+ * AlnCacheStore.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "AlnCacheStore.hpp"
+
+#include <njhseq/IO/InputStream.hpp>
+#include <njhseq/IO/OutputStream.hpp>
+
+#include <unistd.h>
+#include <random>
+
+namespace njhseq {
+
+AlnCacheStore::AlnCacheStore(const bfs::path & storeDir,
+		const aligner & alignerObj) :
+		storeDir_(storeDir), paramsKey_(genParamsKey(alignerObj)),
+		paramsDir_(njh::files::make_path(storeDir, paramsKey_)),
+		segmentsDir_(njh::files::make_path(paramsDir_, "segments")) {
+	njh::files::makeDirP(njh::files::MkdirPar(segmentsDir_.string()));
+	njh::files::makeDirP(njh::files::MkdirPar(njh::files::make_path(paramsDir_, "tmp").string()));
+	auto paramsFnp = njh::files::make_path(paramsDir_, "params.json");
+	if (!bfs::exists(paramsFnp)) {
+		//write to a temp file and rename so another run never reads a partial file
+		auto tempParamsFnp = njh::files::make_path(paramsDir_, "tmp", genSegmentName() + "_params.json");
+		{
+			Json::Value params;
+			params["gapScores"] = alignerObj.parts_.gapScores_.toJson();
+			Json::Value & mat = params["scoringMatrix"];
+			for (const auto & row : alignerObj.parts_.scoring_.mat_) {
+				Json::Value rowJson;
+				for (const auto & score : row) {
+					rowJson.append(score);
+				}
+				mat.append(rowJson);
+			}
+			OutputStream paramsOut(tempParamsFnp);
+			paramsOut << params << std::endl;
+		}
+		bfs::rename(tempParamsFnp, paramsFnp);
+	}
+}
+
+std::string AlnCacheStore::genParamsKey(const aligner & alignerObj) {
+	std::stringstream paramsStr;
+	paramsStr << alignerObj.parts_.gapScores_.toJson();
+	for (const auto & row : alignerObj.parts_.scoring_.mat_) {
+		for (const auto & score : row) {
+			paramsStr << score << ",";
+		}
+		paramsStr << "\n";
+	}
+	std::stringstream ret;
+	ret << std::hex << std::setw(16) << std::setfill('0')
+			<< stableHash(paramsStr.str());
+	return ret.str();
+}
+
+uint64_t AlnCacheStore::stableHash(const std::string & str) {
+	uint64_t ret = 14695981039346656037ULL;
+	for (const auto c : str) {
+		ret ^= static_cast<uint8_t>(c);
+		ret *= 1099511628211ULL;
+	}
+	return ret;
+}
+
+uint64_t AlnCacheStore::pairHash(const std::string & holderType,
+		const std::string & gapKey, const std::string & seq1,
+		const std::string & seq2) {
+	return stableHash(njh::pasteAsStr(holderType, "\t", gapKey, "\t", seq1, "\t", seq2));
+}
+
+bfs::path AlnCacheStore::seqIndexFnp(const bfs::path & segmentDir) {
+	return njh::files::make_path(segmentDir, "seqHashes.txt");
+}
+
+bfs::path AlnCacheStore::pairIndexFnp(const bfs::path & segmentDir) {
+	return njh::files::make_path(segmentDir, "pairHashes.txt");
+}
+
+std::unordered_set<uint64_t> AlnCacheStore::readIndex(const bfs::path & indexFnp) {
+	std::unordered_set<uint64_t> ret;
+	InputStream indexIn(indexFnp);
+	std::string line;
+	while (njh::files::crossPlatGetline(indexIn, line)) {
+		if ("" != line) {
+			ret.emplace(std::stoull(line, nullptr, 16));
+		}
+	}
+	return ret;
+}
+
+namespace {
+
+/**@brief move the alignments in from where both sequences are relevant into to
+ *
+ */
+template<typename HOLDERS>
+uint64_t mergeRelevantAlns(HOLDERS & to, HOLDERS & from,
+		const std::unordered_set<uint64_t> & relevantSeqHashes) {
+	uint64_t ret = 0;
+	for (auto & holder : from) {
+		auto & infos = holder.second.infos_;
+		for (auto seq1It = infos.begin(); seq1It != infos.end();) {
+			if (!njh::in(AlnCacheStore::stableHash(seq1It->first), relevantSeqHashes)) {
+				seq1It = infos.erase(seq1It);
+				continue;
+			}
+			for (auto seq2It = seq1It->second.begin(); seq2It != seq1It->second.end();) {
+				if (!njh::in(AlnCacheStore::stableHash(seq2It->first), relevantSeqHashes)) {
+					seq2It = seq1It->second.erase(seq2It);
+				} else {
+					++seq2It;
+				}
+			}
+			if (seq1It->second.empty()) {
+				seq1It = infos.erase(seq1It);
+			} else {
+				ret += seq1It->second.size();
+				++seq1It;
+			}
+		}
+		if (infos.empty()) {
+			continue;
+		}
+		auto search = to.find(holder.first);
+		if (to.end() == search) {
+			to.emplace(holder.first, std::move(holder.second));
+		} else {
+			for (auto & seq1 : infos) {
+				auto & toSeq1 = search->second.infos_[seq1.first];
+				for (auto & seq2 : seq1.second) {
+					toSeq1.emplace(seq2.first, std::move(seq2.second));
+				}
+			}
+		}
+	}
+	return ret;
+}
+
+/**@brief remove the alignments that are already published from holders, adding the hashes of the rest to the indexes
+ *
+ */
+template<typename HOLDERS>
+void removePublishedAlns(HOLDERS & holders, const std::string & holderType,
+		const std::unordered_set<uint64_t> & publishedPairs,
+		std::set<uint64_t> & seqHashes, std::set<uint64_t> & pairHashes,
+		const std::function<uint64_t(const std::string &, const std::string &,
+				const std::string &, const std::string &)> & genPairHash) {
+	for (auto holderIt = holders.begin(); holderIt != holders.end();) {
+		auto & infos = holderIt->second.infos_;
+		for (auto seq1It = infos.begin(); seq1It != infos.end();) {
+			for (auto seq2It = seq1It->second.begin(); seq2It != seq1It->second.end();) {
+				auto pHash = genPairHash(holderType, holderIt->first, seq1It->first, seq2It->first);
+				if (njh::in(pHash, publishedPairs)) {
+					seq2It = seq1It->second.erase(seq2It);
+				} else {
+					pairHashes.emplace(pHash);
+					seqHashes.emplace(AlnCacheStore::stableHash(seq2It->first));
+					++seq2It;
+				}
+			}
+			if (seq1It->second.empty()) {
+				seq1It = infos.erase(seq1It);
+			} else {
+				seqHashes.emplace(AlnCacheStore::stableHash(seq1It->first));
+				++seq1It;
+			}
+		}
+		if (infos.empty()) {
+			holderIt = holders.erase(holderIt);
+		} else {
+			++holderIt;
+		}
+	}
+}
+
+void writeIndex(const bfs::path & indexFnp, const std::set<uint64_t> & hashes) {
+	OutputStream indexOut(indexFnp);
+	for (const auto & hash : hashes) {
+		indexOut << std::hex << std::setw(16) << std::setfill('0') << hash << "\n";
+	}
+}
+
+}  // namespace
+
+std::string AlnCacheStore::genSegmentName() const {
+	std::random_device rd;
+	return njh::pasteAsStr(
+			std::chrono::system_clock::now().time_since_epoch().count(), "_",
+			getpid(), "_", rd());
+}
+
+std::vector<bfs::path> AlnCacheStore::listSegments() const {
+	std::vector<bfs::path> ret;
+	if (bfs::exists(segmentsDir_)) {
+		for (const auto & segment : bfs::directory_iterator(segmentsDir_)) {
+			if (bfs::is_directory(segment.path())) {
+				ret.emplace_back(segment.path());
+			}
+		}
+	}
+	njh::sort(ret);
+	return ret;
+}
+
+uint64_t AlnCacheStore::load(aligner & alignerObj,
+		const std::unordered_set<std::string> & relevantSeqs, bool verbose) {
+	std::unordered_set<uint64_t> relevantSeqHashes;
+	for (const auto & seq : relevantSeqs) {
+		relevantSeqHashes.emplace(stableHash(seq));
+	}
+	uint64_t loaded = 0;
+	uint32_t skipped = 0;
+	for (const auto & segment : listSegments()) {
+		try {
+			//segments without an index are from before indexing was added and always have to be read
+			if (bfs::exists(seqIndexFnp(segment))) {
+				auto segmentSeqHashes = readIndex(seqIndexFnp(segment));
+				bool shareSeqs = false;
+				for (const auto & seqHash : segmentSeqHashes) {
+					if (njh::in(seqHash, relevantSeqHashes)) {
+						shareSeqs = true;
+						break;
+					}
+				}
+				if (!shareSeqs) {
+					++skipped;
+					continue;
+				}
+			}
+			//read into an empty aligner so only the relevant alignments get added to alignerObj
+			aligner segmentAligner(alignerObj.parts_.maxSize_, alignerObj.parts_.gapScores_, alignerObj.parts_.scoring_);
+			segmentAligner.processAlnInfoInput(segment.string(), false);
+			loaded += mergeRelevantAlns(alignerObj.alnHolder_.globalHolder_, segmentAligner.alnHolder_.globalHolder_, relevantSeqHashes);
+			loaded += mergeRelevantAlns(alignerObj.alnHolder_.localHolder_, segmentAligner.alnHolder_.localHolder_, relevantSeqHashes);
+			loadedSegments_.emplace_back(segment);
+		} catch (std::exception & e) {
+			//a segment that can't be read is treated as a cache miss
+			if (verbose) {
+				std::cerr << __PRETTY_FUNCTION__ << ", skipping " << segment << ": " << e.what() << std::endl;
+			}
+		}
+	}
+	if (verbose) {
+		std::cout << "Loaded " << loaded << " shared alignments from " << loadedSegments_.size()
+				<< " segments, skipped " << skipped << " segments with none of the sequences" << std::endl;
+	}
+	return loaded;
+}
+
+bfs::path AlnCacheStore::publish(const aligner & alignerObj, bool verbose) {
+	//gather what's already published, this includes segments published by other runs since this run loaded
+	std::unordered_set<uint64_t> publishedPairs;
+	for (const auto & segment : listSegments()) {
+		try {
+			if (bfs::exists(pairIndexFnp(segment))) {
+				auto segmentPairs = readIndex(pairIndexFnp(segment));
+				publishedPairs.insert(segmentPairs.begin(), segmentPairs.end());
+			}
+		} catch (std::exception & e) {
+			if (verbose) {
+				std::cerr << __PRETTY_FUNCTION__ << ", couldn't read index of " << segment << ": " << e.what() << std::endl;
+			}
+		}
+	}
+	auto newAlns = alignerObj.alnHolder_;
+	std::set<uint64_t> seqHashes;
+	std::set<uint64_t> pairHashes;
+	removePublishedAlns(newAlns.globalHolder_, "global", publishedPairs, seqHashes, pairHashes, pairHash);
+	removePublishedAlns(newAlns.localHolder_, "local", publishedPairs, seqHashes, pairHashes, pairHash);
+	if (pairHashes.empty()) {
+		if (verbose) {
+			std::cout << "No new alignments to publish to " << paramsDir_ << std::endl;
+		}
+		return "";
+	}
+	auto segmentName = genSegmentName();
+	auto tempDir = njh::files::make_path(paramsDir_, "tmp", segmentName);
+	njh::files::makeDirP(njh::files::MkdirPar(tempDir.string()));
+	newAlns.write(tempDir.string(), verbose);
+	writeIndex(seqIndexFnp(tempDir), seqHashes);
+	writeIndex(pairIndexFnp(tempDir), pairHashes);
+	auto segmentDir = njh::files::make_path(segmentsDir_, segmentName);
+	bfs::rename(tempDir, segmentDir);
+	if (verbose) {
+		std::cout << "Published " << pairHashes.size() << " new alignments to " << segmentDir << std::endl;
+	}
+	return segmentDir;
+}
+
+}  // namespace njhseq
@@ -0,0 +1,105 @@
+#pragma once
+/*
+ * AlnCacheStore.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include <njhseq/common.h>
+#include <njhseq/alignment/aligner/aligner.hpp>
+
+namespace njhseq {
+
+/**@brief A directory of alignment caches that can be shared by many qluster/processClusters runs, even at the same time
+ *
+ * Alignments are grouped by a key generated from the gap and scoring parameters of the aligner so only alignments made
+ * with the same parameters are ever loaded. Each group is a set of immutable segments, each a regular alignment cache directory
+ * plus an index of the hashes of the sequences and of the alignment pairs it holds. A run only loads the alignments between
+ * the sequences it will compare, segments that share no sequences with the run are skipped without being read. At the end a
+ * run publishes one new segment with only the alignments no published segment already has, it's written to a temporary
+ * directory first and then renamed into place so other runs only ever see complete segments
+ *
+ */
+class AlnCacheStore {
+public:
+	/**@brief set up the store for the parameters of alignerObj, creates the directories if needed
+	 *
+	 * @param storeDir the top directory of the store
+	 * @param alignerObj the aligner whose parameters determine which alignments can be shared
+	 */
+	AlnCacheStore(const bfs::path & storeDir, const aligner & alignerObj);
+
+	bfs::path storeDir_;
+	std::string paramsKey_;
+	bfs::path paramsDir_;
+	bfs::path segmentsDir_;
+
+	std::vector<bfs::path> loadedSegments_; /**< the segments load() read alignments from*/
+
+	/**@brief generate the key for the alignment parameters
+	 *
+	 * @param alignerObj the aligner
+	 * @return a hex string hash of the gap parameters and scoring matrix
+	 */
+	static std::string genParamsKey(const aligner & alignerObj);
+
+	/**@brief a hash that is the same across runs and builds, used for anything written to the store
+	 *
+	 * @param str the string to hash
+	 * @return 64 bit FNV-1a hash of str
+	 */
+	static uint64_t stableHash(const std::string & str);
+
+	/**@brief list the currently published segments
+	 *
+	 * @return the segment directories, sorted
+	 */
+	std::vector<bfs::path> listSegments() const;
+
+	/**@brief load the alignments between relevantSeqs from the published segments into alignerObj's cache
+	 *
+	 * @param alignerObj the aligner to load into
+	 * @param relevantSeqs the sequences that will be aligned, only alignments where both sequences are in here are loaded
+	 * @param verbose whether to be verbose
+	 * @return the number of alignments loaded
+	 */
+	uint64_t load(aligner & alignerObj, const std::unordered_set<std::string> & relevantSeqs, bool verbose);
+
+	/**@brief publish the alignments in alignerObj's cache that aren't in any published segment as a new segment
+	 *
+	 * @param alignerObj the aligner to publish the cache of
+	 * @param verbose whether to be verbose
+	 * @return the path of the new segment, blank if there was nothing new to publish
+	 */
+	bfs::path publish(const aligner & alignerObj, bool verbose);
+
+private:
+	std::string genSegmentName() const;
+
+	static bfs::path seqIndexFnp(const bfs::path & segmentDir);
+	static bfs::path pairIndexFnp(const bfs::path & segmentDir);
+	static std::unordered_set<uint64_t> readIndex(const bfs::path & indexFnp);
+	static uint64_t pairHash(const std::string & holderType, const std::string & gapKey,
+			const std::string & seq1, const std::string & seq2);
+};
+
+}  // namespace njhseq
@@ -0,0 +1,132 @@
+/*
+ * BandedEditDistance.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "BandedEditDistance.hpp"
+
+namespace njhseq {
+
+void BandedEditDistance::encode(const std::string & seq,
+		std::vector<uint8_t> & codes) {
+	//one bit per base so two bases match when their codes share a bit, wildcards have every bit set
+	codes.resize(seq.size());
+	for (uint32_t pos = 0; pos < seq.size(); ++pos) {
+		switch (seq[pos]) {
+		case 'A':
+		case 'a':
+			codes[pos] = 1;
+			break;
+		case 'C':
+		case 'c':
+			codes[pos] = 2;
+			break;
+		case 'G':
+		case 'g':
+			codes[pos] = 4;
+			break;
+		case 'T':
+		case 't':
+			codes[pos] = 8;
+			break;
+		case '-':
+			codes[pos] = 16;
+			break;
+		default:
+			codes[pos] = 31;
+			break;
+		}
+	}
+}
+
+uint32_t BandedEditDistance::distance(const std::string & ref,
+		const std::string & read, uint32_t maxEdits) {
+	const int64_t refLen = ref.size();
+	const int64_t readLen = read.size();
+	const int64_t lenDiff = readLen - refLen;
+	if (static_cast<uint64_t>(std::abs(lenDiff)) > maxEdits) {
+		return maxEdits + 1;
+	}
+	//moving off the diagonals between 0 and lenDiff by s takes at least 2*s edits on top of the length difference
+	const int64_t slack = (maxEdits - std::abs(lenDiff)) / 2;
+	const int64_t diagLow = std::min<int64_t>(0, lenDiff) - slack;
+	const int64_t diagHigh = std::max<int64_t>(0, lenDiff) + slack;
+	const int64_t width = diagHigh - diagLow + 1;
+	const uint32_t overflow = maxEdits + 1;
+	encode(ref, refCodes_);
+	encode(read, readCodes_);
+	//band position k is diagonal diagLow + k, i.e. read position j = i + diagLow + k, one extra cell on the right so k + 1 is always valid
+	prev_.assign(width + 1, overflow);
+	cur_.assign(width + 1, overflow);
+	for (int64_t k = 0; k < width; ++k) {
+		int64_t j = diagLow + k;
+		if (j >= 0 && j <= readLen) {
+			prev_[k] = std::min<uint32_t>(j, overflow);
+		}
+	}
+	for (int64_t i = 1; i <= refLen; ++i) {
+		//the band positions that fall inside the read for this row
+		const int64_t kStart = std::max<int64_t>(0, -(i + diagLow));
+		const int64_t kStop = std::min<int64_t>(width, readLen - (i + diagLow) + 1);
+		std::fill(cur_.begin(), cur_.end(), overflow);
+		const uint8_t refCode = refCodes_[i - 1];
+		const uint32_t * prev = prev_.data();
+		uint32_t * cur = cur_.data();
+		int64_t kMatchStart = kStart;
+		if (i + diagLow + kStart == 0) {
+			//column 0 is all deletions
+			cur[kStart] = std::min<uint32_t>(i, overflow);
+			++kMatchStart;
+		}
+		//substitutions and deletions only depend on the previous row so this loop has no dependencies between cells, band position k
+		//is read position readOffset + k which is never negative from kMatchStart on
+		const int64_t readOffset = i + diagLow - 1;
+		for (int64_t k = kMatchStart; k < kStop; ++k) {
+			uint32_t sub = prev[k] + (0 == (refCode & readCodes_[readOffset + k]) ? 1 : 0);
+			uint32_t del = prev[k + 1] + 1;
+			cur[k] = std::min(sub, del);
+		}
+		//insertions depend on the cell to the left
+		uint32_t rowMin = cur[kStart];
+		for (int64_t k = kStart + 1; k < kStop; ++k) {
+			cur[k] = std::min(cur[k], cur[k - 1] + 1);
+			rowMin = std::min(rowMin, cur[k]);
+		}
+		if (rowMin >= overflow) {
+			return overflow;
+		}
+		for (int64_t k = kStart; k < kStop; ++k) {
+			cur[k] = std::min(cur[k], overflow);
+		}
+		std::swap(prev_, cur_);
+	}
+	//the end cell is on diagonal lenDiff
+	return std::min(prev_[lenDiff - diagLow], overflow);
+}
+
+bool BandedEditDistance::withinEdits(const std::string & ref,
+		const std::string & read, uint32_t maxEdits) {
+	return distance(ref, read, maxEdits) <= maxEdits;
+}
+
+}  // namespace njhseq
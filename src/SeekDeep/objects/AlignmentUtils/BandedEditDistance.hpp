@@ -0,0 +1,69 @@
+#pragma once
+/*
+ * BandedEditDistance.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include <njhseq/common.h>
+
+namespace njhseq {
+
+/**@brief Global edit distance limited to a band around the diagonals the two sequences' lengths allow, for quickly
+ * telling whether two near identical sequences are within a number of edits
+ *
+ * Only the diagonals that an alignment with at most maxEdits edits could touch are filled so the cost is the
+ * length times the band width rather than the product of the lengths. The rows are plain arrays with no branches
+ * in the inner loop so the compiler can vectorize it. N (and any non ACGT character) matches anything and case is
+ * ignored so the distance is never more than the number of errors the aligner would count for the same sequences
+ *
+ * Not thread safe, the row buffers are reused between calls so use one per thread
+ *
+ */
+class BandedEditDistance {
+public:
+	/**@brief get the edit distance between ref and read if it's at most maxEdits
+	 *
+	 * @param ref the first sequence
+	 * @param read the second sequence
+	 * @param maxEdits the most edits to look for
+	 * @return the edit distance if it's maxEdits or less, otherwise maxEdits + 1
+	 */
+	uint32_t distance(const std::string & ref, const std::string & read,
+			uint32_t maxEdits);
+
+	/**@brief whether ref and read are within maxEdits edits of each other
+	 *
+	 */
+	bool withinEdits(const std::string & ref, const std::string & read,
+			uint32_t maxEdits);
+
+private:
+	std::vector<uint32_t> prev_;
+	std::vector<uint32_t> cur_;
+	std::vector<uint8_t> refCodes_;
+	std::vector<uint8_t> readCodes_;
+
+	static void encode(const std::string & seq, std::vector<uint8_t> & codes);
+};
+
+}  // namespace njhseq
@@ -0,0 +1,11 @@
+#pragma once
+
+/*
+ * BatchUtils.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+
+
+#include "SeekDeep/objects/BatchUtils/BatchRunner.hpp"
@@ -0,0 +1,160 @@
+/*
+ * BatchRunner.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "BatchRunner.hpp"
+
+#include <njhseq/IO/OutputStream.hpp>
+
+#include <numeric>
+#include <atomic>
+
+namespace njhseq {
+
+BatchRunner::BatchRunner(const bfs::path & batchTableFnp,
+		const VecStr & requiredColumns) :
+		batchTableFnp_(batchTableFnp), batchTab_(batchTableFnp, "\t", true) {
+	batchTab_.changeHeaderToLowerCase();
+	auto missing = batchTab_.getMissingHeaders(requiredColumns);
+	if (!missing.empty()) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error " << batchTableFnp_ << " is missing columns: " << njh::conToStr(missing, ",") << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+}
+
+bool BatchRunner::hasColumn(const std::string & colName) const {
+	return njh::in(colName, batchTab_.columnNames_);
+}
+
+std::string BatchRunner::getValue(const VecStr & row,
+		const std::string & colName) const {
+	if (!hasColumn(colName)) {
+		return "";
+	}
+	return row[batchTab_.getColPos(colName)];
+}
+
+void BatchRunner::addRowError(const std::string & dout,
+		const std::string & error) {
+	rowErrors_ << dout << ": " << error << "\n";
+}
+
+void BatchRunner::checkExists(const std::string & dout,
+		const std::string & fnpDescription, const bfs::path & fnp) {
+	if (!bfs::exists(fnp)) {
+		addRowError(dout, njh::pasteAsStr(fnpDescription, " ", fnp, " doesn't exist"));
+	}
+}
+
+void BatchRunner::addRun(const Run & run) {
+	if (njh::in(run.dout_, douts_)) {
+		addRowError(run.dout_, "dout appears more than once");
+	}
+	douts_.emplace(run.dout_);
+	runs_.emplace_back(run);
+}
+
+void BatchRunner::throwIfRowErrors() const {
+	if ("" != rowErrors_.str()) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error in processing " << batchTableFnp_ << "\n";
+		ss << rowErrors_.str();
+		throw std::runtime_error { ss.str() };
+	}
+}
+
+void BatchRunner::runAll(const RunFunc & func, uint32_t numThreads,
+		bool verbose) {
+	std::vector<uint32_t> runPositions(runs_.size());
+	std::iota(runPositions.begin(), runPositions.end(), 0);
+	njh::concurrent::LockableQueue<uint32_t> runQueue(runPositions);
+	std::mutex coutMut;
+	std::atomic<uint32_t> nextWorkerPos{0};
+	std::function<void()> runRuns = [this,&runQueue,&coutMut,&func,&nextWorkerPos,verbose](){
+		const uint32_t workerPos = nextWorkerPos++;
+		uint32_t runPos = 0;
+		while(runQueue.getVal(runPos)){
+			auto & run = runs_[runPos];
+			run.workerPos_ = workerPos;
+			if(verbose){
+				std::lock_guard<std::mutex> lock(coutMut);
+				std::cout << "Starting " << run.dout_ << std::endl;
+			}
+			std::vector<char *> argv;
+			for(auto & arg : run.args_){
+				argv.emplace_back(const_cast<char *>(arg.c_str()));
+			}
+			auto start = std::chrono::steady_clock::now();
+			try {
+				njh::progutils::CmdArgs runCommands(argv.size(), argv.data());
+				int ret = func(run, runCommands);
+				run.status_ = 0 == ret ? "success" : "failed";
+				if(0 != ret){
+					run.message_ = "returned " + estd::to_string(ret);
+				}
+			} catch (std::exception & e) {
+				run.status_ = "failed";
+				run.message_ = njh::replaceString(e.what(), "\n", " ");
+			}
+			run.seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			if(verbose){
+				std::lock_guard<std::mutex> lock(coutMut);
+				std::cout << "Done " << run.dout_ << ", " << run.status_ << " in " << run.seconds_ << "s" << std::endl;
+			}
+		}
+	};
+	njh::concurrent::runVoidFunctionThreaded(runRuns, numThreads);
+}
+
+uint32_t BatchRunner::writeRunsTable(const bfs::path & fnp) const {
+	OutputStream batchRunsOut(fnp);
+	batchRunsOut << "dout\tstatus\tseconds\tcommand\tmessage" << std::endl;
+	uint32_t failedCount = 0;
+	for(const auto & run : runs_){
+		if("success" != run.status_){
+			++failedCount;
+		}
+		batchRunsOut << run.dout_
+				<< "\t" << run.status_
+				<< "\t" << run.seconds_
+				<< "\t" << njh::conToStr(run.args_, " ")
+				<< "\t" << run.message_ << std::endl;
+	}
+	return failedCount;
+}
+
+std::string BatchRunner::singleEndInputFlag(const bfs::path & fnp) {
+	auto fnStr = njh::strToLowerRet(fnp.string());
+	if(njh::endsWith(fnStr, ".fastq.gz") || njh::endsWith(fnStr, ".fq.gz")){
+		return "--fastqgz";
+	}else if(njh::endsWith(fnStr, ".fasta.gz") || njh::endsWith(fnStr, ".fa.gz")){
+		return "--fastagz";
+	}else if(njh::endsWith(fnStr, ".fastq") || njh::endsWith(fnStr, ".fq")){
+		return "--fastq";
+	}
+	return "--fasta";
+}
+
+}  // namespace njhseq
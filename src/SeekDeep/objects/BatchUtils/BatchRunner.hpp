@@ -0,0 +1,200 @@
+#pragma once
+/*
+ * BatchRunner.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include <njhseq/common.h>
+#include <njhseq/objects/dataContainers/tables/table.hpp>
+#include <njhseq/programUtils/seqSetUp.hpp>
+
+#include <future>
+
+namespace njhseq {
+
+/**@brief Runs a program on each row of a batch table within one process, the shared parts of extractorBatch and qlusterBatch
+ *
+ * Rows are validated up front, then run across a pool of threads, a row that throws is marked failed without stopping the others.
+ * When more than one thread is used the rows should be run quietly (see SeekDeepSetUp::quiet_) so they don't interleave on std::cout
+ *
+ */
+class BatchRunner {
+public:
+	struct Run {
+		std::string dout_;
+		VecStr args_; /**< the full command, master program and sub program first*/
+		std::string sharedKey_; /**< runs with the same key have the same arguments other than their input and output and can share what is built from them*/
+		uint32_t workerPos_{0}; /**< the thread running this run, set by runAll, runs on the same worker never run at once*/
+		std::string status_{"notRun"};
+		double seconds_{0};
+		std::string message_;
+	};
+
+	/**@brief read in the batch table, headers are lower cased
+	 *
+	 * @param batchTableFnp a tab delimited table with a header
+	 * @param requiredColumns the lower case columns that must be present, throws if any are missing
+	 */
+	BatchRunner(const bfs::path & batchTableFnp, const VecStr & requiredColumns);
+
+	bfs::path batchTableFnp_;
+	table batchTab_;
+	std::vector<Run> runs_;
+
+	bool hasColumn(const std::string & colName) const;
+	/**@brief get the value of column colName in row, blank if the table doesn't have that column
+	 *
+	 */
+	std::string getValue(const VecStr & row, const std::string & colName) const;
+
+	void addRowError(const std::string & dout, const std::string & error);
+	/**@brief add a row error if fnp doesn't exist
+	 *
+	 * @param dout the row's output directory
+	 * @param fnpDescription what fnp is, e.g. input or id file
+	 * @param fnp the file to check
+	 */
+	void checkExists(const std::string & dout, const std::string & fnpDescription, const bfs::path & fnp);
+	/**@brief add a run, adds a row error if its dout was already used
+	 *
+	 */
+	void addRun(const Run & run);
+	void throwIfRowErrors() const;
+
+	typedef std::function<int(Run & run, const njh::progutils::CmdArgs & commands)> RunFunc;
+
+	/**@brief run every run with func, anything thrown by func fails only that run
+	 *
+	 * @param func run with each run and the commands built from its args, a non-zero return is a failure, run.workerPos_ can be used
+	 * to keep anything that isn't thread safe to a single worker
+	 * @param numThreads the number of runs to do at once
+	 * @param verbose print the start and end of each run
+	 */
+	void runAll(const RunFunc & func, uint32_t numThreads, bool verbose);
+
+	/**@brief write the status of each run, columns dout, status, seconds, command and message
+	 *
+	 * @param fnp the file to write to
+	 * @return the number of runs that didn't succeed
+	 */
+	uint32_t writeRunsTable(const bfs::path & fnp) const;
+
+	/**@brief the input flag for a single end input based on its extension, --fasta if the extension isn't recognized
+	 *
+	 */
+	static std::string singleEndInputFlag(const bfs::path & fnp);
+
+private:
+	std::set<std::string> douts_;
+	std::stringstream rowErrors_;
+};
+
+/**@brief A thread safe cache of objects that are expensive to build and only read once built
+ *
+ * Each key is built once, by whichever thread asks for it first, other threads asking for the same key wait on that build.
+ * A build that throws is cached too so every request for that key throws the same error rather than re-building
+ *
+ */
+template<typename T>
+class SharedBuildCache {
+public:
+	std::shared_ptr<const T> get(const std::string & key,
+			const std::function<std::shared_ptr<const T>()> & build) {
+		std::shared_future<std::shared_ptr<const T>> ret;
+		std::promise<std::shared_ptr<const T>> buildPromise;
+		bool needsBuild = false;
+		{
+			std::lock_guard<std::mutex> lock(mut_);
+			auto search = cache_.find(key);
+			if (cache_.end() == search) {
+				ret = buildPromise.get_future().share();
+				cache_.emplace(key, ret);
+				needsBuild = true;
+			} else {
+				ret = search->second;
+			}
+		}
+		if (needsBuild) {
+			try {
+				buildPromise.set_value(build());
+			} catch (...) {
+				buildPromise.set_exception(std::current_exception());
+			}
+		}
+		return ret.get();
+	}
+
+private:
+	std::mutex mut_;
+	std::unordered_map<std::string, std::shared_future<std::shared_ptr<const T>>> cache_;
+};
+
+/**@brief Holds objects left over from finished runs so later runs with the same key can re-use them rather than building their own
+ *
+ * Only up to maxHeld_ objects are held across all keys, anything checked in past that is dropped
+ *
+ */
+template<typename T>
+class ReusePool {
+public:
+	explicit ReusePool(uint32_t maxHeld) :
+			maxHeld_(maxHeld) {
+	}
+
+	/**@brief take an object held for key
+	 *
+	 * @param key the key the object was checked in under
+	 * @return the object, nullptr if none are held for key
+	 */
+	std::unique_ptr<T> checkOut(const std::string & key) {
+		std::lock_guard<std::mutex> lock(mut_);
+		auto search = held_.find(key);
+		if (held_.end() == search || search->second.empty()) {
+			return nullptr;
+		}
+		auto ret = std::move(search->second.back());
+		search->second.pop_back();
+		--heldCount_;
+		return ret;
+	}
+
+	/**@brief give back an object so a later run with key can use it
+	 *
+	 */
+	void checkIn(const std::string & key, std::unique_ptr<T> obj) {
+		std::lock_guard<std::mutex> lock(mut_);
+		if (nullptr == obj || heldCount_ >= maxHeld_) {
+			return;
+		}
+		held_[key].emplace_back(std::move(obj));
+		++heldCount_;
+	}
+
+private:
+	const uint32_t maxHeld_;
+	std::mutex mut_;
+	uint32_t heldCount_{0};
+	std::unordered_map<std::string, std::vector<std::unique_ptr<T>>> held_;
+};
+
+}  // namespace njhseq
@@ -0,0 +1,16 @@
+#pragma once
+
+/*
+ * ClusteringUtils.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+
+
+#include "SeekDeep/objects/ClusteringUtils/CollapsePreAligner.hpp"
+
+#include "SeekDeep/objects/ClusteringUtils/ReadDedupIndex.hpp"
+#include "SeekDeep/objects/ClusteringUtils/SampleCostScheduler.hpp"
+#include "SeekDeep/objects/ClusteringUtils/SampleResultCache.hpp"
+#include "SeekDeep/objects/ClusteringUtils/SampleMemoryBudget.hpp"
@@ -0,0 +1,105 @@
+/*
+ * CollapsePreAligner.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "CollapsePreAligner.hpp"
+
+namespace njhseq {
+
+const uint64_t CollapsePreAligner::chunkSize_ = 64;
+
+CollapsePreAligner::CollapsePreAligner(const PreAlignPars & pars) :
+		pars_(pars) {
+}
+
+std::vector<uint32_t> CollapsePreAligner::getComparisonOrder(
+		const std::vector<double> & counts) {
+	std::vector<uint32_t> ret(counts.size());
+	std::iota(ret.begin(), ret.end(), 0);
+	std::stable_sort(ret.begin(), ret.end(),
+			[&counts](uint32_t pos1, uint32_t pos2) {
+				return counts[pos1] > counts[pos2];
+			});
+	return ret;
+}
+
+std::vector<uint32_t> CollapsePreAligner::getIterationMaxEdits(
+		const CollapseIterations & iterMap) {
+	std::vector<uint32_t> ret;
+	for (const auto & iter : iterMap.iters_) {
+		ret.emplace_back(getMaxEdits(iter.second.errors_));
+	}
+	return ret;
+}
+
+uint32_t CollapsePreAligner::getMaxEdits(const comparison & errors) {
+	if (errors.largeBaseIndel_ > 0) {
+		return std::numeric_limits<uint32_t>::max();
+	}
+	uint64_t edits = static_cast<uint64_t>(errors.hqMismatches_)
+			+ static_cast<uint64_t>(errors.lqMismatches_)
+			+ static_cast<uint64_t>(errors.lowKmerMismatches_)
+			+ static_cast<uint64_t>(errors.oneBaseIndel_)
+			+ 2 * static_cast<uint64_t>(errors.twoBaseIndel_);
+	return std::min<uint64_t>(edits, std::numeric_limits<uint32_t>::max());
+}
+
+uint32_t CollapsePreAligner::getMaxEdits(const CollapseIterations & iterMap) {
+	uint32_t ret = 0;
+	for (const auto edits : getIterationMaxEdits(iterMap)) {
+		ret = std::max(ret, edits);
+	}
+	return ret;
+}
+
+uint32_t CollapsePreAligner::kmerEditLowerBound(
+		const PackedKmerSet & seq1Kmers, const PackedKmerSet & seq2Kmers) {
+	if (!seq1Kmers.unpackableKmers_.empty() || !seq2Kmers.unpackableKmers_.empty()) {
+		return 0;
+	}
+	uint32_t longerLen = std::max(seq1Kmers.seqLen_, seq2Kmers.seqLen_);
+	if (longerLen < seq1Kmers.kLen_) {
+		return 0;
+	}
+	uint32_t kmersNeeded = longerLen - seq1Kmers.kLen_ + 1;
+	uint32_t kmersShared = seq1Kmers.compareKmers(seq2Kmers).first;
+	if (kmersShared >= kmersNeeded) {
+		return 0;
+	}
+	//each edit can remove at most k of the shared kmers
+	return (kmersNeeded - kmersShared + seq1Kmers.kLen_ - 1) / seq1Kmers.kLen_;
+}
+
+comparison CollapsePreAligner::genFailedCheck() {
+	//no alignment can have this many mismatches so it both fails every iteration and marks the check as added
+	comparison ret;
+	ret.hqMismatches_ = std::numeric_limits<uint32_t>::max();
+	return ret;
+}
+
+bool CollapsePreAligner::isAddedCheck(const comparison & check) {
+	return std::numeric_limits<uint32_t>::max() == check.hqMismatches_;
+}
+
+}  // namespace njhseq
@@ -0,0 +1,453 @@
+#pragma once
+/*
+ * CollapsePreAligner.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include <njhseq/common.h>
+#include <njhseq/alignment/aligner/aligner.hpp>
+#include <njhseq/concurrency/pools/AlignerPool.hpp>
+#include <njhseq/helpers/clusterCollapser.hpp>
+
+#include "SeekDeep/objects/AlignmentUtils/BandedEditDistance.hpp"
+#include "SeekDeep/objects/KmerUtils/PackedKmerSet.hpp"
+
+namespace njhseq {
+
+/**@brief Fill an aligner's cache ahead of a round of collapsing by aligning, across several threads, each cluster
+ * to the larger clusters it's going to be compared against
+ *
+ * The collapsing itself stays serial and makes the same merge decisions in the same order, it just finds most of
+ * the alignments it needs already in the cache
+ *
+ * If maxEdits_ is set, pairs that shared kmers (by the q-gram lemma) or a banded edit distance show are more than maxEdits_
+ * edits apart can't pass any iteration, so rather than being aligned they get a failing check added to each cluster's previousErrorChecks_ which
+ * the collapser uses instead of aligning them. The added checks are marked (see isAddedCheck()) rather than tracked by cluster name since names change
+ * as clusters merge, removeAddedChecks() takes every marked check back out once the clustering is done
+ *
+ * The added checks are made against the sequences the clusters have before clustering, a consensus rebuilt part way through clustering still gets
+ * them, so copyWithoutAddedChecks() and sameClusters() are there to run the same clustering without them and check it comes out the same
+ *
+ */
+class CollapsePreAligner {
+public:
+	struct PreAlignPars {
+		uint32_t numThreads_{1};
+		uint32_t candidatesPerRead_{100}; /**< number of larger clusters each cluster is aligned to, normally the stopCheck_ of the iteration*/
+		bool local_{false};
+		bool verbose_{false};
+		uint32_t maxEdits_{std::numeric_limits<uint32_t>::max()}; /**< pairs further apart than this are skipped, max means don't check*/
+		std::vector<uint32_t> iterationMaxEdits_; /**< the most edits each iteration allows, only used to report how many pairs can't pass each iteration*/
+		uint32_t kmerLength_{5}; /**< kmer length for the shared kmer lower bound*/
+	};
+
+	struct PreAlignCounts {
+		uint64_t candidates_{0};
+		uint64_t aligned_{0};
+		uint64_t skippedByKmers_{0};
+		uint64_t skippedByEdits_{0};
+		std::vector<uint64_t> unpassableByIteration_; /**< for each of iterationMaxEdits_ the number of candidates further apart than it*/
+	};
+
+	explicit CollapsePreAligner(const PreAlignPars & pars);
+
+	PreAlignPars pars_;
+
+	/**@brief get the order clusters are compared in, by read count largest first then by original position
+	 *
+	 * @param counts the read count of each cluster
+	 * @return the positions of the clusters in comparison order
+	 */
+	static std::vector<uint32_t> getComparisonOrder(const std::vector<double> & counts);
+
+	/**@brief get the most edits a pair could have and still pass an iteration
+	 *
+	 * @param iterMap the iterations
+	 * @return the most over all iterations of all allowed mismatches plus one base indels plus twice the two base indels,
+	 * max if any iteration allows large indels since those are unbounded
+	 */
+	static uint32_t getMaxEdits(const CollapseIterations & iterMap);
+
+	/**@brief get the most edits a pair could have and still pass each iteration, in iteration order
+	 *
+	 * @param iterMap the iterations
+	 * @return the edits for each iteration, max for iterations allowing large indels
+	 */
+	static std::vector<uint32_t> getIterationMaxEdits(const CollapseIterations & iterMap);
+
+	/**@brief get the most edits a pair could have and still pass the allowed errors
+	 *
+	 * @param errors the allowed errors
+	 * @return all allowed mismatches plus one base indels plus twice the two base indels, max if large indels are allowed
+	 */
+	static uint32_t getMaxEdits(const comparison & errors);
+
+	/**@brief a lower bound on the edit distance between two sequences from the number of kmers they share, from the q-gram lemma
+	 * a pair within e edits shares at least the longer length - k + 1 - k * e kmers
+	 *
+	 * @param seq1Kmers the kmers of the first sequence
+	 * @param seq2Kmers the kmers of the second sequence
+	 * @return the fewest edits the pair could be apart, 0 if either set has kmers with non ACGT bases since those can't be relied on
+	 */
+	static uint32_t kmerEditLowerBound(const PackedKmerSet & seq1Kmers,
+			const PackedKmerSet & seq2Kmers);
+
+	/**@brief a comparison that won't pass any iteration, marked so it can be told apart from a real comparison by isAddedCheck()
+	 *
+	 */
+	static comparison genFailedCheck();
+
+	/**@brief whether check is one added by preAlign rather than one made by the collapser
+	 *
+	 */
+	static bool isAddedCheck(const comparison & check);
+
+	/**@brief get the pairs that will likely be aligned, the ref is always the larger cluster and the read the smaller as is done when collapsing
+	 *
+	 * @param clusters the clusters
+	 * @return pairs of positions, first is the ref, second is the read
+	 */
+	template<typename T>
+	std::vector<std::pair<uint32_t, uint32_t>> getCandidatePairs(const std::vector<T> & clusters) const {
+		std::vector<double> counts;
+		counts.reserve(clusters.size());
+		for (const auto & clus : clusters) {
+			counts.emplace_back(clus.seqBase_.cnt_);
+		}
+		auto order = getComparisonOrder(counts);
+		std::vector<std::pair<uint32_t, uint32_t>> ret;
+		for (uint32_t readPos = 1; readPos < order.size(); ++readPos) {
+			uint32_t checked = 0;
+			for (uint32_t refPos = 0; refPos < readPos && checked < pars_.candidatesPerRead_; ++refPos) {
+				//identical sequences don't get aligned
+				if (clusters[order[refPos]].seqBase_.seq_ != clusters[order[readPos]].seqBase_.seq_) {
+					ret.emplace_back(order[refPos], order[readPos]);
+					++checked;
+				}
+			}
+		}
+		return ret;
+	}
+
+	/**@brief get the pairs aligned when searching for chimera parents, every cluster paired with each cluster at least parentFreqs times as abundant
+	 *
+	 * @param clusters the clusters
+	 * @param parentFreqs how many times more abundant a cluster has to be to be a possible parent
+	 * @return pairs of positions, first is the possible parent, second is the possible chimera
+	 */
+	template<typename T>
+	static std::vector<std::pair<uint32_t, uint32_t>> getChimeraParentPairs(
+			const std::vector<T> & clusters, double parentFreqs) {
+		std::vector<double> counts;
+		counts.reserve(clusters.size());
+		for (const auto & clus : clusters) {
+			counts.emplace_back(clus.seqBase_.cnt_);
+		}
+		auto order = getComparisonOrder(counts);
+		std::vector<std::pair<uint32_t, uint32_t>> ret;
+		for (uint32_t chiPos = 1; chiPos < order.size(); ++chiPos) {
+			const auto & chi = clusters[order[chiPos]];
+			//in abundance order so the parents are all at the start
+			for (uint32_t parentPos = 0; parentPos < chiPos; ++parentPos) {
+				const auto & parent = clusters[order[parentPos]];
+				if (parent.seqBase_.cnt_ < parentFreqs * chi.seqBase_.cnt_) {
+					break;
+				}
+				if (parent.seqBase_.seq_ != chi.seqBase_.seq_) {
+					ret.emplace_back(order[parentPos], order[chiPos]);
+				}
+			}
+		}
+		return ret;
+	}
+
+	/**@brief align the candidate pairs across pars_.numThreads_ aligners and then load the results into alignerObj's cache
+	 *
+	 * @param clusters the clusters about to be collapsed, pairs too far apart get a failing check added
+	 * @param alignerObj the aligner that will be used for collapsing
+	 * @param scratchDir a directory to hold the alignments from the threads, removed when done
+	 * @return the number of candidate pairs, aligned pairs and skipped pairs
+	 */
+	template<typename T>
+	PreAlignCounts preAlign(std::vector<T> & clusters, aligner & alignerObj,
+			const bfs::path & scratchDir) {
+		if ((pars_.numThreads_ <= 1 && std::numeric_limits<uint32_t>::max() == pars_.maxEdits_) || clusters.size() < 2) {
+			return PreAlignCounts{};
+		}
+		auto pairs = getCandidatePairs(clusters);
+		return preAlignPairs(clusters, pairs, alignerObj, scratchDir);
+	}
+
+	/**@brief align the given pairs across pars_.numThreads_ aligners and then load the results into alignerObj's cache
+	 *
+	 * @param clusters the clusters, pairs too far apart get a failing check added
+	 * @param pairs positions in clusters, first is the ref, second is the read
+	 * @param alignerObj the aligner to load the alignments into
+	 * @param scratchDir a directory to hold the alignments from the threads, removed when done
+	 * @return the number of candidate pairs, aligned pairs, skipped pairs and pairs that can't pass each iteration
+	 */
+	template<typename T>
+	PreAlignCounts preAlignPairs(std::vector<T> & clusters,
+			const std::vector<std::pair<uint32_t, uint32_t>> & pairs,
+			aligner & alignerObj, const bfs::path & scratchDir) {
+		PreAlignCounts counts;
+		counts.candidates_ = pairs.size();
+		if (pairs.empty()) {
+			return counts;
+		}
+		//checks left from a previous round would make pairs fail that this round might let through
+		throwIfAddedChecks(clusters, __PRETTY_FUNCTION__);
+		const uint32_t maxEdits = pars_.maxEdits_;
+		const bool checkEdits = std::numeric_limits<uint32_t>::max() != maxEdits;
+		//only align when there are threads to spare, otherwise the collapser aligns as it goes
+		const bool align = pars_.numThreads_ > 1;
+		//the kmer sets are only made for clusters that are in a pair
+		std::vector<std::unique_ptr<PackedKmerSet>> kmerSets(clusters.size());
+		if (checkEdits && pars_.kmerLength_ > 0 && pars_.kmerLength_ <= 32) {
+			for (const auto & pair : pairs) {
+				for (const auto pos : {pair.first, pair.second}) {
+					if (nullptr == kmerSets[pos]) {
+						kmerSets[pos] = std::make_unique<PackedKmerSet>(clusters[pos].seqBase_.seq_, pars_.kmerLength_, false);
+					}
+				}
+			}
+		}
+		//the fewest edits each pair could be apart, maxEdits + 1 if it can't be within maxEdits
+		std::vector<uint32_t> lowerBounds(pairs.size(), 0);
+		std::atomic<uint64_t> skippedByKmers{0};
+		std::vector<std::pair<uint32_t, uint32_t>> failedPairs;
+		std::mutex failedPairsMut;
+		//hand out pairs in chunks so threads aren't fighting over the queue lock for every alignment
+		std::vector<uint64_t> chunkStarts;
+		for (uint64_t start = 0; start < pairs.size(); start += chunkSize_) {
+			chunkStarts.emplace_back(start);
+		}
+		njh::concurrent::LockableQueue<uint64_t> chunkQueue(chunkStarts);
+		bool local = pars_.local_;
+		auto processChunks = [&chunkQueue,&pairs,&clusters,&failedPairs,&failedPairsMut,
+													&kmerSets,&lowerBounds,&skippedByKmers,
+													local,maxEdits,checkEdits](aligner * currentAligner){
+			BandedEditDistance editDist;
+			std::vector<std::pair<uint32_t, uint32_t>> currentFailed;
+			uint64_t chunkStart = 0;
+			while (chunkQueue.getVal(chunkStart)) {
+				uint64_t chunkStop = std::min<uint64_t>(chunkStart + chunkSize_, pairs.size());
+				for (uint64_t pos = chunkStart; pos < chunkStop; ++pos) {
+					const auto & ref = clusters[pairs[pos].first];
+					const auto & read = clusters[pairs[pos].second];
+					if (checkEdits) {
+						//the kmer bound is cheaper so it goes first, the banded distance then catches what it can't
+						if (nullptr != kmerSets[pairs[pos].first] && nullptr != kmerSets[pairs[pos].second]) {
+							lowerBounds[pos] = kmerEditLowerBound(*kmerSets[pairs[pos].first], *kmerSets[pairs[pos].second]);
+						}
+						if (lowerBounds[pos] > maxEdits) {
+							++skippedByKmers;
+							currentFailed.emplace_back(pairs[pos]);
+							continue;
+						}
+						lowerBounds[pos] = editDist.distance(ref.seqBase_.seq_, read.seqBase_.seq_, maxEdits);
+						if (lowerBounds[pos] > maxEdits) {
+							currentFailed.emplace_back(pairs[pos]);
+							continue;
+						}
+					}
+					if (nullptr == currentAligner) {
+						continue;
+					}
+					if (local) {
+						currentAligner->alignCacheLocal(ref, read);
+					} else {
+						currentAligner->alignCacheGlobal(ref, read);
+					}
+				}
+			}
+			std::lock_guard<std::mutex> lock(failedPairsMut);
+			addOtherVec(failedPairs, currentFailed);
+		};
+		if (align) {
+			{
+				concurrent::AlignerPool alnPool(alignerObj, pars_.numThreads_);
+				alnPool.initAligners();
+				alnPool.outAlnDir_ = scratchDir.string();
+				std::function<void()> alignPairs = [&alnPool,&processChunks](){
+					auto currentAligner = alnPool.popAligner();
+					processChunks(currentAligner.get());
+				};
+				njh::concurrent::runVoidFunctionThreaded(alignPairs, pars_.numThreads_);
+			}
+			//the pool writes out each aligner's cache to scratchDir when it is destroyed
+			alignerObj.processAlnInfoInput(scratchDir.string(), pars_.verbose_);
+			njh::files::rmDirForce(scratchDir);
+		} else {
+			processChunks(nullptr);
+		}
+		for (const auto & failed : failedPairs) {
+			addFailedCheck(clusters[failed.first], clusters[failed.second]);
+		}
+		counts.skippedByKmers_ = skippedByKmers;
+		counts.skippedByEdits_ = failedPairs.size() - counts.skippedByKmers_;
+		if (checkEdits) {
+			for (const auto iterMaxEdits : pars_.iterationMaxEdits_) {
+				counts.unpassableByIteration_.emplace_back(
+						std::count_if(lowerBounds.begin(), lowerBounds.end(),
+								[&iterMaxEdits](uint32_t lowerBound) {return lowerBound > iterMaxEdits;}));
+			}
+		}
+		counts.aligned_ = align ? counts.candidates_ - counts.skippedByKmers_ - counts.skippedByEdits_ : 0;
+		return counts;
+	}
+
+	/**@brief take back out the failing checks added by preAlign so they don't carry over into clustering with other parameters
+	 *
+	 * @param clusters the clusters after clustering, every cluster is checked so it doesn't matter if they were renamed or merged
+	 * @return the number of checks removed
+	 */
+	template<typename T>
+	uint64_t removeAddedChecks(std::vector<T> & clusters) {
+		uint64_t removed = 0;
+		for (auto & clus : clusters) {
+			for (auto check = clus.previousErrorChecks_.begin(); check != clus.previousErrorChecks_.end();) {
+				if (isAddedCheck(check->second)) {
+					check = clus.previousErrorChecks_.erase(check);
+					++removed;
+				} else {
+					++check;
+				}
+			}
+		}
+		return removed;
+	}
+
+	/**@brief whether any cluster has a check added by preAlign
+	 *
+	 * @param clusters the clusters to check
+	 */
+	template<typename T>
+	static bool hasAddedChecks(const std::vector<T> & clusters) {
+		for (const auto & clus : clusters) {
+			for (const auto & check : clus.previousErrorChecks_) {
+				if (isAddedCheck(check.second)) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	/**@brief copy clusters without any checks added by preAlign, each copy gets its own copy of its reads so the copies can be clustered
+	 * without touching the originals
+	 *
+	 * @param clusters the clusters to copy
+	 * @return the copies
+	 */
+	template<typename T>
+	static std::vector<T> copyWithoutAddedChecks(const std::vector<T> & clusters) {
+		std::vector<T> ret = clusters;
+		for (auto & clus : ret) {
+			for (auto & read : clus.reads_) {
+				read = std::make_shared<typename std::remove_reference<decltype(*read)>::type>(*read);
+			}
+			for (auto check = clus.previousErrorChecks_.begin(); check != clus.previousErrorChecks_.end();) {
+				if (isAddedCheck(check->second)) {
+					check = clus.previousErrorChecks_.erase(check);
+				} else {
+					++check;
+				}
+			}
+		}
+		return ret;
+	}
+
+	/**@brief compare two clusterings of the same input by the name, sequence and read count of each cluster not marked for removal
+	 *
+	 * @param expected the expected clusters, e.g. clustered from copyWithoutAddedChecks()
+	 * @param actual the clusters to check
+	 * @param diffs the clusters only found in one of the two are written here
+	 * @return whether the clusterings are the same
+	 */
+	template<typename T>
+	static bool sameClusters(const std::vector<T> & expected,
+			const std::vector<T> & actual, std::ostream & diffs) {
+		auto genKeys = [](const std::vector<T> & clusters) {
+			std::map<std::string, uint32_t> ret;
+			for (const auto & clus : clusters) {
+				if (!clus.remove) {
+					++ret[njh::pasteAsStr(clus.seqBase_.name_, "\t", clus.seqBase_.cnt_, "\t", clus.seqBase_.seq_)];
+				}
+			}
+			return ret;
+		};
+		auto expectedKeys = genKeys(expected);
+		auto actualKeys = genKeys(actual);
+		bool same = true;
+		for (const auto & key : expectedKeys) {
+			if (!njh::in(key.first, actualKeys) || actualKeys.at(key.first) != key.second) {
+				same = false;
+				diffs << "expected\t" << key.first << "\n";
+			}
+		}
+		for (const auto & key : actualKeys) {
+			if (!njh::in(key.first, expectedKeys) || expectedKeys.at(key.first) != key.second) {
+				same = false;
+				diffs << "actual\t" << key.first << "\n";
+			}
+		}
+		return same;
+	}
+
+	/**@brief throw if any cluster still has a check added by preAlign
+	 *
+	 * @param clusters the clusters to check
+	 * @param funcName the function checking, for the error message
+	 */
+	template<typename T>
+	static void throwIfAddedChecks(const std::vector<T> & clusters, const std::string & funcName) {
+		for (const auto & clus : clusters) {
+			for (const auto & check : clus.previousErrorChecks_) {
+				if (isAddedCheck(check.second)) {
+					std::stringstream ss;
+					ss << funcName << ", error " << clus.seqBase_.name_ << " still has a check added by pre-aligning against " << check.first
+							<< ", removeAddedChecks() needs to be called after clustering" << "\n";
+					throw std::runtime_error { ss.str() };
+				}
+			}
+		}
+	}
+
+	static const uint64_t chunkSize_;
+
+private:
+	template<typename T>
+	static void addFailedCheck(T & ref, T & read) {
+		//edit distance is symmetric so the check holds which ever cluster ends up being compared to the other
+		auto failed = genFailedCheck();
+		if (!njh::in(read.seqBase_.name_, ref.previousErrorChecks_)) {
+			ref.previousErrorChecks_[read.seqBase_.name_] = failed;
+		}
+		if (!njh::in(ref.seqBase_.name_, read.previousErrorChecks_)) {
+			read.previousErrorChecks_[ref.seqBase_.name_] = failed;
+		}
+	}
+};
+
+}  // namespace njhseq
@@ -0,0 +1,124 @@
+/*
+ * ReadDedupIndex.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "ReadDedupIndex.hpp"
+
+namespace njhseq {
+
+void ReadDedupIndex::rehash(uint64_t numSlots) {
+	slots_.assign(numSlots, 0);
+	const uint64_t mask = numSlots - 1;
+	for (uint32_t id = 0; id < size_; ++id) {
+		uint64_t slot = hashes_[id] & mask;
+		while (0 != slots_[slot]) {
+			slot = (slot + 1) & mask;
+		}
+		slots_[slot] = id + 1;
+	}
+}
+
+uint32_t ReadDedupIndex::add(const std::string & seq, uint64_t filePos,
+		const SeqGetter & getSeq) {
+	if (finalized_ || indexReleased_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error can't add after finalize() or releaseIndex() has been called" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	//kept at most half full so probe runs stay short
+	if (2 * (static_cast<uint64_t>(size_) + 1) > slots_.size()) {
+		rehash(std::max<uint64_t>(1024, slots_.size() * 2));
+	}
+	const uint64_t hash = std::hash<std::string>()(seq);
+	const uint64_t mask = slots_.size() - 1;
+	uint64_t slot = hash & mask;
+	while (0 != slots_[slot]) {
+		uint32_t id = slots_[slot] - 1;
+		if (hashes_[id] == hash && getSeq(id) == seq) {
+			pendingPositions_.emplace_back(id, filePos);
+			return id;
+		}
+		slot = (slot + 1) & mask;
+	}
+	uint32_t id = size_;
+	++size_;
+	hashes_.emplace_back(hash);
+	slots_[slot] = id + 1;
+	pendingPositions_.emplace_back(id, filePos);
+	return id;
+}
+
+uint32_t ReadDedupIndex::size() const {
+	return size_;
+}
+
+void ReadDedupIndex::releaseIndex() {
+	hashes_ = std::vector<uint64_t>{};
+	slots_ = std::vector<uint32_t>{};
+	indexReleased_ = true;
+}
+
+void ReadDedupIndex::finalize() {
+	//counting sort on id, keeps the positions of each id in the order they were read
+	positionStarts_.assign(size_ + 1, 0);
+	for (const auto & pending : pendingPositions_) {
+		++positionStarts_[pending.first + 1];
+	}
+	for (uint32_t id = 0; id < size_; ++id) {
+		positionStarts_[id + 1] += positionStarts_[id];
+	}
+	positions_.resize(pendingPositions_.size());
+	std::vector<uint64_t> fillPos(positionStarts_.begin(), positionStarts_.end() - 1);
+	for (const auto & pending : pendingPositions_) {
+		positions_[fillPos[pending.first]++] = pending.second;
+	}
+	pendingPositions_ = std::vector<std::pair<uint32_t, uint64_t>>{};
+	finalized_ = true;
+}
+
+ReadDedupIndex::PositionRange ReadDedupIndex::getPositions(uint32_t id) const {
+	if (!finalized_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error finalize() has to be called before getting positions" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	if (id >= size_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error id " << id << " out of range, size: " << size_ << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	if (positions_.empty()) {
+		return PositionRange { nullptr, nullptr };
+	}
+	return PositionRange { positions_.data() + positionStarts_[id],
+			positions_.data() + positionStarts_[id + 1] };
+}
+
+void ReadDedupIndex::clearPositions() {
+	pendingPositions_ = std::vector<std::pair<uint32_t, uint64_t>>{};
+	positions_ = std::vector<uint64_t>{};
+	std::fill(positionStarts_.begin(), positionStarts_.end(), 0);
+}
+
+}  // namespace njhseq
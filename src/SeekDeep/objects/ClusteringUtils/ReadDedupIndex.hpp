@@ -0,0 +1,108 @@
+#pragma once
+/*
+ * ReadDedupIndex.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include <njhseq/common.h>
+
+namespace njhseq {
+
+/**@brief Index for collapsing reads to unique sequences while reading in, gives each unique sequence an integer id and keeps where in the input file each of its reads was
+ *
+ * This only speeds up the read in dedup, it doesn't store the sequences or qualities, the clusters made from them are still regular cluster objects.
+ * The caller keeps one copy of each unique sequence at its id and the index only keeps a 64 bit hash
+ * per id in an open addressing table, so collapsing is linear rather than comparing each read to every unique sequence so far. The table
+ * can be freed with releaseIndex() once all sequences are added. File positions are kept as (id, position) pairs while reading and then
+ * turned into one flat array indexed by id with finalize()
+ *
+ */
+class ReadDedupIndex {
+public:
+
+	struct PositionRange {
+		const uint64_t * begin_;
+		const uint64_t * end_;
+		const uint64_t * begin() const {
+			return begin_;
+		}
+		const uint64_t * end() const {
+			return end_;
+		}
+		uint64_t size() const {
+			return end_ - begin_;
+		}
+	};
+
+	typedef std::function<const std::string &(uint32_t id)> SeqGetter;
+
+	/**@brief add a sequence and the file position it was read from
+	 *
+	 * @param seq the sequence
+	 * @param filePos the position in the input file
+	 * @param getSeq gets the caller's copy of the sequence with an id already given out, used to check sequences with the same hash
+	 * @return the id of the sequence, ids are given out in the order sequences are first seen starting at 0, if it's the same as size()
+	 * before the add the sequence is new and the caller should store it at that id
+	 */
+	uint32_t add(const std::string & seq, uint64_t filePos, const SeqGetter & getSeq);
+
+	/**@brief the number of unique sequences
+	 *
+	 */
+	uint32_t size() const;
+
+	/**@brief free the hash table, no more sequences can be added after this
+	 *
+	 */
+	void releaseIndex();
+
+	/**@brief build the flat file position arrays, has to be called after all adds and before getPositions()
+	 *
+	 */
+	void finalize();
+
+	/**@brief the file positions of all the reads that had the sequence with id
+	 *
+	 */
+	PositionRange getPositions(uint32_t id) const;
+
+	/**@brief free the file positions
+	 *
+	 */
+	void clearPositions();
+
+private:
+	uint32_t size_{0};
+	std::vector<uint64_t> hashes_; /**< hash of each id's sequence*/
+	std::vector<uint32_t> slots_; /**< open addressing table of id + 1, 0 is empty*/
+	bool indexReleased_{false};
+
+	std::vector<std::pair<uint32_t, uint64_t>> pendingPositions_;
+	std::vector<uint64_t> positionStarts_;
+	std::vector<uint64_t> positions_;
+	bool finalized_{false};
+
+	void rehash(uint64_t numSlots);
+};
+
+}  // namespace njhseq
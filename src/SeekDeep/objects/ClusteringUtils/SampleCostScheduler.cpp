@@ -0,0 +1,152 @@
+/*
+ * SampleCostScheduler.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "SampleCostScheduler.hpp"
+
+namespace njhseq {
+
+SampleCostScheduler::SampleCostScheduler(
+		const std::unordered_map<std::string, std::vector<bfs::path>> & sampleFiles) :
+		start_(std::chrono::steady_clock::now()) {
+	std::unordered_map<std::string, double> metaCosts;
+	std::unordered_map<std::string, double> sizeCosts;
+	for (const auto & samp : sampleFiles) {
+		metaCosts[samp.first] = 0;
+		sizeCosts[samp.first] = 0;
+		for (const auto & fnp : samp.second) {
+			sizeCosts[samp.first] += bfs::file_size(fnp);
+			if (!costsFromMetaData_) {
+				continue;
+			}
+			auto metaDataJsonFnp = njh::files::make_path(fnp.parent_path(), "metaData.json");
+			bool found = false;
+			if (bfs::exists(metaDataJsonFnp)) {
+				auto metaJson = njh::json::parseFile(metaDataJsonFnp.string());
+				if (metaJson.isMember("inputReadCount") && metaJson.isMember("uniqueSeqCount")
+						&& metaJson.isMember("outputFile")
+						&& fnp.filename().string() == metaJson["outputFile"].asString()) {
+					metaCosts[samp.first] += metaJson["inputReadCount"].asDouble() * metaJson["uniqueSeqCount"].asDouble();
+					found = true;
+				}
+			}
+			if (!found) {
+				costsFromMetaData_ = false;
+			}
+		}
+	}
+	const auto & costs = costsFromMetaData_ ? metaCosts : sizeCosts;
+	for (const auto & cost : costs) {
+		costs_.emplace_back(cost.first, cost.second);
+	}
+	//ties go by name so the order is the same from run to run
+	njh::sort(costs_, [](const std::pair<std::string, double> & p1, const std::pair<std::string, double> & p2) {
+		if (p1.second == p2.second) {
+			return p1.first < p2.first;
+		}
+		return p1.second > p2.second;
+	});
+}
+
+double SampleCostScheduler::secondsSinceStart() const {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+}
+
+uint32_t SampleCostScheduler::registerThread() {
+	std::lock_guard<std::mutex> lock(mut_);
+	runningByThread_.emplace_back(-1);
+	return threadCount_++;
+}
+
+bool SampleCostScheduler::getNext(std::string & samp, uint32_t threadNum) {
+	std::lock_guard<std::mutex> lock(mut_);
+	if (threadNum >= threadCount_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error thread number " << threadNum
+				<< " wasn't registered, only " << threadCount_ << " threads have been" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	double now = secondsSinceStart();
+	if (runningByThread_[threadNum] >= 0) {
+		timings_[runningByThread_[threadNum]].stopSeconds_ = now;
+		runningByThread_[threadNum] = -1;
+	}
+	//one shared queue in cost order, a thread that finishes early simply takes the next largest sample left
+	if (nextSample_ >= costs_.size()) {
+		return false;
+	}
+	SampleTiming timing;
+	timing.sample_ = costs_[nextSample_].first;
+	timing.estimatedCost_ = costs_[nextSample_].second;
+	timing.order_ = nextSample_;
+	timing.thread_ = threadNum;
+	timing.startSeconds_ = now;
+	runningByThread_[threadNum] = timings_.size();
+	timings_.emplace_back(timing);
+	samp = timing.sample_;
+	++nextSample_;
+	return true;
+}
+
+double SampleCostScheduler::wallSeconds() const {
+	if (timings_.empty()) {
+		return 0;
+	}
+	double firstStart = std::numeric_limits<double>::max();
+	double lastStop = 0;
+	for (const auto & timing : timings_) {
+		firstStart = std::min(firstStart, timing.startSeconds_);
+		lastStop = std::max(lastStop, timing.stopSeconds_);
+	}
+	return lastStop > firstStart ? lastStop - firstStart : 0;
+}
+
+double SampleCostScheduler::utilization() const {
+	double wall = wallSeconds();
+	if (0 == wall || 0 == threadCount_) {
+		return 0;
+	}
+	double busy = 0;
+	for (const auto & timing : timings_) {
+		busy += timing.stopSeconds_ - timing.startSeconds_;
+	}
+	return busy / (wall * threadCount_);
+}
+
+void SampleCostScheduler::writeTimes(const OutOptions & outOpts) const {
+	OutputStream out(outOpts);
+	out << "sample\testimatedCost\tcostSource\torder\tthread\tstartSeconds\tstopSeconds\tseconds" << std::endl;
+	for (const auto & timing : timings_) {
+		out << timing.sample_
+				<< "\t" << timing.estimatedCost_
+				<< "\t" << (costsFromMetaData_ ? "inputReadCount*uniqueSeqCount" : "fileSize")
+				<< "\t" << timing.order_
+				<< "\t" << timing.thread_
+				<< "\t" << timing.startSeconds_
+				<< "\t" << timing.stopSeconds_
+				<< "\t" << timing.stopSeconds_ - timing.startSeconds_ << std::endl;
+	}
+}
+
+}  // namespace njhseq
@@ -0,0 +1,104 @@
+#pragma once
+/*
+ * SampleCostScheduler.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include <njhseq/common.h>
+#include <njhseq/IO/OutputStream.hpp>
+#include <chrono>
+
+namespace njhseq {
+
+/**@brief Hands out samples to worker threads largest estimated cost first and records when each thread ran each sample
+ *
+ * The cost of a sample is the sum over its replicates of the qluster input read count times the unique sequence count from
+ * the metaData.json next to each replicate's clustered file, if any replicate is missing them the clustered file sizes are used for all samples instead
+ *
+ */
+class SampleCostScheduler {
+public:
+
+	struct SampleTiming {
+		std::string sample_;
+		double estimatedCost_{0};
+		uint32_t order_{0};
+		uint32_t thread_{0};
+		double startSeconds_{0};
+		double stopSeconds_{0};
+	};
+
+	/**@brief construct from the clustered files of each sample
+	 *
+	 * @param sampleFiles key is sample name, value is the clustered file of each replicate
+	 */
+	SampleCostScheduler(const std::unordered_map<std::string, std::vector<bfs::path>> & sampleFiles);
+
+	bool costsFromMetaData_{true}; /**< whether the costs came from qluster meta data or from file sizes*/
+
+	std::vector<std::pair<std::string, double>> costs_; /**< samples and their estimated cost, largest first*/
+
+	/**@brief get a number for the calling thread to use with getNext()
+	 *
+	 * @return the thread number
+	 */
+	uint32_t registerThread();
+
+	/**@brief get the next sample to run, stopping the clock on the last sample this thread was given
+	 *
+	 * @param samp the sample to run
+	 * @param threadNum the number from registerThread()
+	 * @return false if there are no more samples
+	 */
+	bool getNext(std::string & samp, uint32_t threadNum);
+
+	/**@brief write a table of when each sample was started and stopped and on which thread
+	 *
+	 * @param outOpts where to write
+	 */
+	void writeTimes(const OutOptions & outOpts) const;
+
+	/**@brief the fraction of the time from the first start to the last stop that the threads spent running samples
+	 *
+	 * @return the utilization, 0 if nothing has run
+	 */
+	double utilization() const;
+
+	/**@brief seconds from the first start to the last stop
+	 *
+	 * @return wall seconds
+	 */
+	double wallSeconds() const;
+
+private:
+	std::mutex mut_;
+	std::chrono::steady_clock::time_point start_;
+	uint32_t nextSample_{0};
+	uint32_t threadCount_{0};
+	std::vector<SampleTiming> timings_;
+	std::vector<int64_t> runningByThread_;/**< position in timings_ of each thread's current sample, -1 if none*/
+
+	double secondsSinceStart() const;
+};
+
+}  // namespace njhseq
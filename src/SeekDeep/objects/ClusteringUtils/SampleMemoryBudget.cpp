@@ -0,0 +1,68 @@
+/*
+ * SampleMemoryBudget.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "SampleMemoryBudget.hpp"
+
+namespace njhseq {
+
+const uint64_t SampleMemoryBudget::objectOverhead_ = 256;
+
+SampleMemoryBudget::SampleMemoryBudget(uint64_t maxBytes) :
+		maxBytes_(maxBytes) {
+}
+
+VecStr SampleMemoryBudget::add(const std::string & sample, uint64_t bytes) {
+	std::lock_guard<std::mutex> lock(mut_);
+	if (njh::in(sample, residentNames_)) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error " << sample << " was already added" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	resident_.emplace_back(sample, bytes);
+	residentNames_.emplace(sample);
+	residentBytes_ += bytes;
+	peakBytes_ = std::max(peakBytes_, residentBytes_);
+	VecStr ret;
+	while ((residentBytes_ > maxBytes_ || (writeAllOnceOver_ && spilledCount_ > 0)) && !resident_.empty()) {
+		ret.emplace_back(resident_.front().first);
+		residentBytes_ -= resident_.front().second;
+		residentNames_.erase(resident_.front().first);
+		resident_.pop_front();
+		++spilledCount_;
+	}
+	return ret;
+}
+
+uint64_t SampleMemoryBudget::peakBytes() const {
+	std::lock_guard<std::mutex> lock(mut_);
+	return peakBytes_;
+}
+
+uint32_t SampleMemoryBudget::spilledCount() const {
+	std::lock_guard<std::mutex> lock(mut_);
+	return spilledCount_;
+}
+
+}  // namespace njhseq
@@ -0,0 +1,97 @@
+#pragma once
+/*
+ * SampleMemoryBudget.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include <njhseq/common.h>
+#include <deque>
+#include <unordered_set>
+
+namespace njhseq {
+
+/**@brief Keeps track of how much memory the finished samples are estimated to be holding and which ones to write out
+ * to stay under a budget, the first finished first
+ *
+ */
+class SampleMemoryBudget {
+public:
+	/**@brief set up the budget
+	 *
+	 * @param maxBytes the most bytes the resident samples should hold
+	 */
+	explicit SampleMemoryBudget(uint64_t maxBytes);
+
+	uint64_t maxBytes_;
+	bool writeAllOnceOver_{false}; /**< once any sample has had to be written out write out every sample, for when a later step needs either every sample in memory or every sample on disk*/
+
+	/**@brief add a sample that is now being held in memory
+	 *
+	 * @param sample the sample name
+	 * @param bytes the estimated size of the sample
+	 * @return the samples that should be written out to get back under the budget, the first added first, removed from the budget
+	 */
+	VecStr add(const std::string & sample, uint64_t bytes);
+
+	uint64_t peakBytes() const;
+	uint32_t spilledCount() const;
+
+	/**@brief estimate the memory used by the clusters of a sample collapse
+	 *
+	 * @param sampCollapse a sample collapse with input_, excluded_ and collapsed_ cluster sets
+	 * @return the estimated bytes
+	 */
+	template<typename T>
+	static uint64_t estimateBytes(const T & sampCollapse) {
+		uint64_t ret = 0;
+		for (const auto & clusters : { &sampCollapse.input_.clusters_,
+				&sampCollapse.excluded_.clusters_, &sampCollapse.collapsed_.clusters_ }) {
+			for (const auto & clus : *clusters) {
+				ret += estimateSeqBytes(clus.seqBase_);
+				for (const auto & read : clus.reads_) {
+					ret += estimateSeqBytes(read->seqBase_);
+				}
+			}
+		}
+		return ret;
+	}
+
+	template<typename SEQ>
+	static uint64_t estimateSeqBytes(const SEQ & seqBase) {
+		//the strings plus the qualities plus a rough amount for the object and its counts
+		return seqBase.name_.size() + seqBase.seq_.size()
+				+ seqBase.qual_.size() * sizeof(uint32_t) + objectOverhead_;
+	}
+
+	static const uint64_t objectOverhead_;
+
+private:
+	mutable std::mutex mut_;
+	std::deque<std::pair<std::string, uint64_t>> resident_; /**< the samples in memory and their estimated sizes, the first added at the front*/
+	std::unordered_set<std::string> residentNames_;
+	uint64_t residentBytes_{0};
+	uint64_t peakBytes_{0};
+	uint32_t spilledCount_{0};
+};
+
+}  // namespace njhseq
@@ -0,0 +1,276 @@
+/*
+ * SampleResultCache.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "SampleResultCache.hpp"
+#include <unistd.h>
+#include <random>
+#include <array>
+
+namespace njhseq {
+
+namespace {
+
+/**@brief SHA-256, used so the cache keys are the same across builds and platforms unlike std::hash
+ *
+ */
+class Sha256 {
+public:
+	void update(const char * data, std::size_t len) {
+		for (std::size_t pos = 0; pos < len; ++pos) {
+			block_[blockLen_] = static_cast<uint8_t>(data[pos]);
+			++blockLen_;
+			if (64 == blockLen_) {
+				transform();
+				totalBits_ += 512;
+				blockLen_ = 0;
+			}
+		}
+	}
+
+	void update(const std::string & str) {
+		update(str.data(), str.size());
+	}
+
+	std::string hexDigest() {
+		uint64_t totalBits = totalBits_ + blockLen_ * 8;
+		block_[blockLen_] = 0x80;
+		++blockLen_;
+		if (blockLen_ > 56) {
+			std::fill(block_.begin() + blockLen_, block_.end(), 0);
+			transform();
+			blockLen_ = 0;
+		}
+		std::fill(block_.begin() + blockLen_, block_.begin() + 56, 0);
+		for (uint32_t pos = 0; pos < 8; ++pos) {
+			block_[63 - pos] = static_cast<uint8_t>(totalBits >> (pos * 8));
+		}
+		transform();
+		std::stringstream ret;
+		for (const auto word : state_) {
+			ret << std::hex << std::setw(8) << std::setfill('0') << word;
+		}
+		return ret.str();
+	}
+
+private:
+	std::array<uint32_t, 8> state_ { { 0x6a09e667, 0xbb67ae85, 0x3c6ef372,
+			0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 } };
+	std::array<uint8_t, 64> block_ { };
+	uint32_t blockLen_ { 0 };
+	uint64_t totalBits_ { 0 };
+
+	static uint32_t rotr(uint32_t val, uint32_t bits) {
+		return (val >> bits) | (val << (32 - bits));
+	}
+
+	void transform() {
+		static const std::array<uint32_t, 64> k { { 0x428a2f98, 0x71374491,
+				0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+				0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+				0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1,
+				0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa,
+				0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8,
+				0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+				0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354,
+				0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+				0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585,
+				0x106aa070, 0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+				0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3, 0x748f82ee,
+				0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb,
+				0xbef9a3f7, 0xc67178f2 } };
+		std::array<uint32_t, 64> w;
+		for (uint32_t pos = 0; pos < 16; ++pos) {
+			w[pos] = (static_cast<uint32_t>(block_[pos * 4]) << 24)
+					| (static_cast<uint32_t>(block_[pos * 4 + 1]) << 16)
+					| (static_cast<uint32_t>(block_[pos * 4 + 2]) << 8)
+					| static_cast<uint32_t>(block_[pos * 4 + 3]);
+		}
+		for (uint32_t pos = 16; pos < 64; ++pos) {
+			uint32_t s0 = rotr(w[pos - 15], 7) ^ rotr(w[pos - 15], 18) ^ (w[pos - 15] >> 3);
+			uint32_t s1 = rotr(w[pos - 2], 17) ^ rotr(w[pos - 2], 19) ^ (w[pos - 2] >> 10);
+			w[pos] = w[pos - 16] + s0 + w[pos - 7] + s1;
+		}
+		auto vals = state_;
+		for (uint32_t pos = 0; pos < 64; ++pos) {
+			uint32_t s1 = rotr(vals[4], 6) ^ rotr(vals[4], 11) ^ rotr(vals[4], 25);
+			uint32_t ch = (vals[4] & vals[5]) ^ (~vals[4] & vals[6]);
+			uint32_t temp1 = vals[7] + s1 + ch + k[pos] + w[pos];
+			uint32_t s0 = rotr(vals[0], 2) ^ rotr(vals[0], 13) ^ rotr(vals[0], 22);
+			uint32_t maj = (vals[0] & vals[1]) ^ (vals[0] & vals[2]) ^ (vals[1] & vals[2]);
+			uint32_t temp2 = s0 + maj;
+			vals[7] = vals[6];
+			vals[6] = vals[5];
+			vals[5] = vals[4];
+			vals[4] = vals[3] + temp1;
+			vals[3] = vals[2];
+			vals[2] = vals[1];
+			vals[1] = vals[0];
+			vals[0] = temp1 + temp2;
+		}
+		for (uint32_t pos = 0; pos < 8; ++pos) {
+			state_[pos] += vals[pos];
+		}
+	}
+};
+
+}  // namespace
+
+
+SampleResultCache::SampleResultCache(const bfs::path & cacheDir,
+		const std::string & paramsStr) :
+		cacheDir_(cacheDir), paramsStr_(paramsStr) {
+	checkHashKnownAnswers();
+	njh::files::makeDirP(njh::files::MkdirPar(njh::files::make_path(cacheDir_, "tmp").string()));
+}
+
+std::string SampleResultCache::hashStr(const std::string & str) {
+	Sha256 hasher;
+	hasher.update(str);
+	return hasher.hexDigest();
+}
+
+void SampleResultCache::checkHashKnownAnswers() {
+	//the two 448 and 896 bit messages end right where the padding needs a second block
+	const std::vector<std::pair<std::string, std::string>> knownAnswers {
+			{ "", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+			{ "abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+			{ "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+					"248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+			{ "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+					"cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1" } };
+	for (const auto & knownAnswer : knownAnswers) {
+		auto digest = hashStr(knownAnswer.first);
+		if (digest != knownAnswer.second) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error SHA-256 of \"" << knownAnswer.first << "\" gave " << digest
+					<< " rather than " << knownAnswer.second << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+	}
+}
+
+std::string SampleResultCache::hashFile(const bfs::path & fnp) {
+	std::ifstream in(fnp.string(), std::ios::binary);
+	if (!in) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error couldn't open " << fnp << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	//hash in chunks so large files don't have to be held in memory
+	Sha256 hasher;
+	std::string buffer(1024 * 1024, '\0');
+	while (in.read(&buffer[0], buffer.size()) || in.gcount() > 0) {
+		hasher.update(buffer.data(), in.gcount());
+	}
+	return hasher.hexDigest();
+}
+
+std::string SampleResultCache::genSampleKey(const std::string & sample,
+		const std::vector<bfs::path> & inputFiles, const bfs::path & inputDir,
+		const std::string & sampleParamsStr) const {
+	std::vector<bfs::path> sortedFiles = inputFiles;
+	njh::sort(sortedFiles);
+	std::stringstream keyStr;
+	keyStr << paramsStr_ << "\n" << sample << "\n" << sampleParamsStr << "\n";
+	for (const auto & fnp : sortedFiles) {
+		keyStr << fnp.string() << "\t" << hashFile(njh::files::make_path(inputDir, fnp)) << "\n";
+	}
+	return keyStr.str();
+}
+
+bfs::path SampleResultCache::getEntryDir(const std::string & sample,
+		const std::string & key) const {
+	return njh::files::make_path(cacheDir_, sample, hashStr(key));
+}
+
+bool SampleResultCache::has(const std::string & sample,
+		const std::string & key) const {
+	auto keyFnp = njh::files::make_path(getEntryDir(sample, key), "key.txt");
+	if (!bfs::exists(keyFnp)) {
+		return false;
+	}
+	//the directory is only named by the key's hash, the full key is checked so a collision or a damaged entry is a miss
+	std::ifstream keyFile(keyFnp.string(), std::ios::binary);
+	std::stringstream storedKey;
+	storedKey << keyFile.rdbuf();
+	return storedKey.str() == key;
+}
+
+void SampleResultCache::copyDir(const bfs::path & fromDir,
+		const bfs::path & toDir) {
+	bfs::create_directories(toDir);
+	for (bfs::recursive_directory_iterator iter(fromDir), end; iter != end; ++iter) {
+		auto target = njh::files::make_path(toDir, bfs::relative(iter->path(), fromDir));
+		if (bfs::is_directory(iter->path())) {
+			bfs::create_directories(target);
+		} else {
+			bfs::copy_file(iter->path(), target, bfs::copy_option::overwrite_if_exists);
+		}
+	}
+}
+
+void SampleResultCache::restore(const std::string & sample,
+		const std::string & key, const bfs::path & sampleOutDir) const {
+	if (!has(sample, key)) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error no cached results for " << sample
+				<< " with key " << key << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	if (bfs::exists(sampleOutDir)) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error " << sampleOutDir
+				<< " already exists" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	copyDir(njh::files::make_path(getEntryDir(sample, key), "results"), sampleOutDir);
+}
+
+void SampleResultCache::store(const std::string & sample,
+		const std::string & key, const bfs::path & sampleOutDir) const {
+	std::random_device rd;
+	auto tempDir = njh::files::make_path(cacheDir_, "tmp",
+			njh::pasteAsStr(sample, "_", hashStr(key), "_", getpid(), "_", rd()));
+	copyDir(sampleOutDir, njh::files::make_path(tempDir, "results"));
+	{
+		std::ofstream keyFile(njh::files::make_path(tempDir, "key.txt").string(), std::ios::binary);
+		keyFile << key;
+	}
+	auto entryDir = getEntryDir(sample, key);
+	bfs::create_directories(entryDir.parent_path());
+	//same key means same results, so if another run already stored this sample keep theirs
+	if (bfs::exists(entryDir)) {
+		njh::files::rmDirForce(tempDir);
+		return;
+	}
+	try {
+		bfs::rename(tempDir, entryDir);
+	} catch (std::exception & e) {
+		//another run stored it between the check and the rename
+		njh::files::rmDirForce(tempDir);
+	}
+}
+
+}  // namespace njhseq
@@ -0,0 +1,111 @@
+#pragma once
+/*
+ * SampleResultCache.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include <njhseq/common.h>
+
+namespace njhseq {
+
+/**@brief A directory of processClusters per sample results so a rerun only has to redo samples that are new or have changed
+ *
+ * Each sample's dumped results are stored under the sample's name in a directory named by the SHA-256 of a key made from
+ * the parameters and the sample's clustered input files, so any change to either is simply a cache miss. The full key is
+ * stored with the results and checked before they're used. Results are copied into a temporary directory first and then
+ * renamed into place so a run never restores a partial copy
+ *
+ */
+class SampleResultCache {
+public:
+	/**@brief set up the cache, creates the directory if needed
+	 *
+	 * @param cacheDir the top directory of the cache
+	 * @param paramsStr a string of every parameter that can change a sample's results
+	 */
+	SampleResultCache(const bfs::path & cacheDir, const std::string & paramsStr);
+
+	bfs::path cacheDir_;
+	std::string paramsStr_;
+
+	/**@brief SHA-256 of a string
+	 *
+	 * @param str the string
+	 * @return 64 hex characters
+	 */
+	static std::string hashStr(const std::string & str);
+
+	/**@brief SHA-256 of the contents of a file
+	 *
+	 * @param fnp the file
+	 * @return 64 hex characters
+	 */
+	static std::string hashFile(const bfs::path & fnp);
+
+	/**@brief throw if hashStr() doesn't give the published SHA-256 digests for the FIPS 180-2 example messages, called when the cache is set up
+	 *
+	 */
+	static void checkHashKnownAnswers();
+
+	/**@brief generate the key for a sample
+	 *
+	 * @param sample the sample name
+	 * @param inputFiles the sample's clustered input files, the paths relative to the master directory should be given so a moved project still hits the cache
+	 * @param inputDir the directory the input files are relative to
+	 * @param sampleParamsStr any parameters specific to this sample (e.g. custom cut offs)
+	 * @return the key, the parameters, sample and each input file with the hash of its contents
+	 */
+	std::string genSampleKey(const std::string & sample,
+			const std::vector<bfs::path> & inputFiles, const bfs::path & inputDir,
+			const std::string & sampleParamsStr) const;
+
+	/**@brief whether there are results stored for sample under exactly key
+	 *
+	 */
+	bool has(const std::string & sample, const std::string & key) const;
+
+	/**@brief copy the cached results of a sample into sampleOutDir
+	 *
+	 * @param sample the sample name
+	 * @param key the sample's key
+	 * @param sampleOutDir where the sample's results are expected, can't already exist
+	 */
+	void restore(const std::string & sample, const std::string & key,
+			const bfs::path & sampleOutDir) const;
+
+	/**@brief add the results in sampleOutDir to the cache, if there are already results for the same key (e.g. stored by another run) those are kept
+	 *
+	 * @param sample the sample name
+	 * @param key the sample's key
+	 * @param sampleOutDir the directory holding the sample's results
+	 */
+	void store(const std::string & sample, const std::string & key,
+			const bfs::path & sampleOutDir) const;
+
+	static void copyDir(const bfs::path & fromDir, const bfs::path & toDir);
+
+private:
+	bfs::path getEntryDir(const std::string & sample, const std::string & key) const;
+};
+
+}  // namespace njhseq
@@ -20,6 +20,18 @@ public:
 		std::regex_match(name_, match_, nameRegPat_);
 	}
 
+	/**@brief construct with an already compiled pattern so a regex isn't rebuilt for every read name
+	 *
+	 * @param name the read name
+	 * @param nameRegPat the compiled name pattern
+	 * @param sampleNumberPos the position of the sample number in the match
+	 */
+	IlluminaNameFormatDecoder(const std::string & name,
+			const std::regex & nameRegPat, const uint32_t sampleNumberPos) : name_(name) ,
+			nameRegPat_(nameRegPat), sampleNumberPos_(sampleNumberPos) {
+		std::regex_match(name_, match_, nameRegPat_);
+	}
+
 	IlluminaNameFormatDecoder(const std::string & name):
 			IlluminaNameFormatDecoder(name, DefaultNameRegPatStr_,
 					DefaultSampleNumberPos_) {
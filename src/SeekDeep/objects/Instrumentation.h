@@ -0,0 +1,12 @@
+#pragma once
+
+/*
+ * Instrumentation.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+
+
+#include "SeekDeep/objects/Instrumentation/StageTimer.hpp"
+
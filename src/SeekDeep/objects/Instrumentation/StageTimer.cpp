@@ -0,0 +1,213 @@
+/*
+ * StageTimer.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "StageTimer.hpp"
+
+namespace njhseq {
+
+void StageTimer::StageCounts::add(double wallSeconds, uint64_t reads) {
+	wallSeconds_ += wallSeconds;
+	++calls_;
+	reads_ += reads;
+}
+
+void StageTimer::StageCounts::addCpu(double cpuSeconds) {
+	cpuSeconds_ += cpuSeconds;
+	++cpuTimedCalls_;
+}
+
+void StageTimer::StageCounts::merge(const StageCounts & other) {
+	wallSeconds_ += other.wallSeconds_;
+	cpuSeconds_ += other.cpuSeconds_;
+	calls_ += other.calls_;
+	cpuTimedCalls_ += other.cpuTimedCalls_;
+	reads_ += other.reads_;
+}
+
+Json::Value StageTimer::StageCounts::toJson() const {
+	Json::Value ret;
+	ret["wallSeconds"] = wallSeconds_;
+	ret["calls"] = njh::json::toJson(calls_);
+	ret["reads"] = njh::json::toJson(reads_);
+	ret["readsPerWallSecond"] = wallSeconds_ > 0 ? reads_ / wallSeconds_ : 0.0;
+	if (cpuTimedCalls_ > 0) {
+		ret["cpuSeconds"] = cpuSeconds_;
+		ret["cpuTimedCalls"] = njh::json::toJson(cpuTimedCalls_);
+	}
+	return ret;
+}
+
+const uint32_t StageTimer::noGroup_ = 0;
+
+std::atomic<uint64_t> StageTimer::nextId_ { 1 };
+
+StageTimer::StageTimer() :
+		id_(nextId_++), groupNames_ { "" } {
+	groupIds_[""] = noGroup_;
+}
+
+StageTimer::Lap::Lap(StageTimer & timer, uint32_t stage, uint32_t group,
+		uint64_t reads, bool cpuTime) :
+		timer_(timer), stage_(stage), group_(group), reads_(reads),
+		wallStart_(std::chrono::steady_clock::now()), cpuTime_(cpuTime) {
+	if (cpuTime_) {
+		cpuStart_ = StageTimer::threadCpuSeconds();
+	}
+}
+
+StageTimer::Lap::~Lap() {
+	stop();
+}
+
+void StageTimer::Lap::stop() {
+	if (running_) {
+		running_ = false;
+		double wallSeconds = std::chrono::duration<double>(
+				std::chrono::steady_clock::now() - wallStart_).count();
+		auto & counts = timer_.add(stage_, group_, wallSeconds, reads_);
+		if (cpuTime_) {
+			counts.addCpu(StageTimer::threadCpuSeconds() - cpuStart_);
+		}
+	}
+}
+
+void StageTimer::Lap::setGroup(uint32_t group) {
+	group_ = group;
+}
+
+void StageTimer::Lap::setReads(uint64_t reads) {
+	reads_ = reads;
+}
+
+uint32_t StageTimer::registerStage(const std::string & stage) {
+	std::lock_guard<std::mutex> lock(mut_);
+	auto search = stageIds_.find(stage);
+	if (stageIds_.end() != search) {
+		return search->second;
+	}
+	uint32_t id = stageNames_.size();
+	stageNames_.emplace_back(stage);
+	stageIds_[stage] = id;
+	return id;
+}
+
+uint32_t StageTimer::getGroupId(const std::string & group) {
+	std::lock_guard<std::mutex> lock(mut_);
+	auto search = groupIds_.find(group);
+	if (groupIds_.end() != search) {
+		return search->second;
+	}
+	uint32_t id = groupNames_.size();
+	groupNames_.emplace_back(group);
+	groupIds_[group] = id;
+	return id;
+}
+
+StageTimer::ThreadCounts & StageTimer::localCounts() {
+	//remember the last timer this thread recorded to so the common case doesn't need the lock
+	struct LastUsed {
+		uint64_t timerId_{0};
+		ThreadCounts * counts_{nullptr};
+	};
+	thread_local LastUsed lastUsed;
+	if (lastUsed.timerId_ != id_) {
+		std::lock_guard<std::mutex> lock(mut_);
+		auto & counts = threadCounts_[std::this_thread::get_id()];
+		if (nullptr == counts) {
+			counts = std::make_unique<ThreadCounts>();
+		}
+		lastUsed.timerId_ = id_;
+		lastUsed.counts_ = counts.get();
+	}
+	return *lastUsed.counts_;
+}
+
+StageTimer::StageCounts & StageTimer::add(uint32_t stage, uint32_t group,
+		double wallSeconds, uint64_t reads) {
+	auto & counts = localCounts().counts_;
+	if (group >= counts.size()) {
+		counts.resize(group + 1);
+	}
+	auto & groupCounts = counts[group];
+	if (stage >= groupCounts.size()) {
+		groupCounts.resize(stage + 1);
+	}
+	groupCounts[stage].add(wallSeconds, reads);
+	return groupCounts[stage];
+}
+
+double StageTimer::threadCpuSeconds() {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+	timespec ts;
+	if (0 == clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts)) {
+		return ts.tv_sec + ts.tv_nsec / 1e9;
+	}
+#endif
+	return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+}
+
+Json::Value StageTimer::toJson() const {
+	std::lock_guard<std::mutex> lock(mut_);
+	//merge the threads, totals are the sum over every group including noGroup_
+	std::map<std::string, StageCounts> totals;
+	std::map<std::string, std::map<std::string, StageCounts>> groups;
+	for (const auto & thread : threadCounts_) {
+		const auto & counts = thread.second->counts_;
+		for (uint32_t group = 0; group < counts.size(); ++group) {
+			for (uint32_t stage = 0; stage < counts[group].size(); ++stage) {
+				const auto & stageCounts = counts[group][stage];
+				if (0 == stageCounts.calls_) {
+					continue;
+				}
+				totals[stageNames_[stage]].merge(stageCounts);
+				if (noGroup_ != group) {
+					groups[groupNames_[group]][stageNames_[stage]].merge(stageCounts);
+				}
+			}
+		}
+	}
+	Json::Value ret;
+	auto & totalsJson = ret["totals"];
+	totalsJson = Json::objectValue;
+	for (const auto & stage : totals) {
+		totalsJson[stage.first] = stage.second.toJson();
+	}
+	auto & groupsJson = ret["groups"];
+	groupsJson = Json::objectValue;
+	for (const auto & group : groups) {
+		auto & groupJson = groupsJson[group.first];
+		for (const auto & stage : group.second) {
+			groupJson[stage.first] = stage.second.toJson();
+		}
+	}
+	return ret;
+}
+
+void StageTimer::writeJson(const OutOptions & outOpts) const {
+	OutputStream out(outOpts);
+	out << toJson() << std::endl;
+}
+
+}  // namespace njhseq
@@ -0,0 +1,173 @@
+#pragma once
+/*
+ * StageTimer.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include <njhseq/common.h>
+#include <njhseq/IO/OutputStream.hpp>
+#include <chrono>
+#include <ctime>
+#include <atomic>
+#include <thread>
+#include <mutex>
+
+namespace njhseq {
+
+/**@brief Accumulates wall time, number of calls and number of reads (and cpu time for laps that ask for it) for stages of a program,
+ * both overall and per group (e.g. per MID or per MID/target)
+ *
+ * Stages and groups are registered up front and laps are recorded by id into arrays local to the recording thread, so a lap
+ * is a steady clock read at each end and two vector indexes. Thread cpu time needs a system call so it's only taken for
+ * laps that ask for it, meant for coarse laps like closing a file rather than per read work
+ *
+ */
+class StageTimer {
+public:
+
+	struct StageCounts {
+		double wallSeconds_{0};
+		double cpuSeconds_{0};
+		uint64_t calls_{0};
+		uint64_t cpuTimedCalls_{0};
+		uint64_t reads_{0};
+
+		void add(double wallSeconds, uint64_t reads);
+		void addCpu(double cpuSeconds);
+		void merge(const StageCounts & other);
+
+		Json::Value toJson() const;
+	};
+
+	static const uint32_t noGroup_; /**< the group id for time that only goes towards the totals*/
+
+	StageTimer();
+
+	/**@brief Times from construction until stop() or destruction and adds it to the timer, so early continues in loops still get counted
+	 *
+	 */
+	class Lap {
+	public:
+		Lap(StageTimer & timer, uint32_t stage, uint32_t group,
+				uint64_t reads = 1, bool cpuTime = false);
+		~Lap();
+
+		void stop();
+
+		/**@brief change the group the time will be recorded under, for when the group isn't known until part way through the stage
+		 *
+		 * @param group the new group id
+		 */
+		void setGroup(uint32_t group);
+
+		/**@brief change the number of reads the time will be recorded for, for when a stage handles a whole file at once
+		 *
+		 * @param reads the number of reads
+		 */
+		void setReads(uint64_t reads);
+
+	private:
+		StageTimer & timer_;
+		uint32_t stage_;
+		uint32_t group_;
+		uint64_t reads_;
+		std::chrono::steady_clock::time_point wallStart_;
+		bool cpuTime_;
+		double cpuStart_{0};
+		bool running_{true};
+	};
+
+	/**@brief register a stage, registering the same name again gives the same id
+	 *
+	 * @param stage the stage name
+	 * @return the id to record the stage with
+	 */
+	uint32_t registerStage(const std::string & stage);
+
+	/**@brief get the id of a group, registering it if it hasn't been seen yet, a blank name gives noGroup_
+	 *
+	 * @param group the group name
+	 * @return the id to record the group with
+	 */
+	uint32_t getGroupId(const std::string & group);
+
+	/**@brief record time for a stage
+	 *
+	 * @param stage the stage id
+	 * @param group the group id, if noGroup_ only the totals are updated
+	 * @param wallSeconds wall time in seconds
+	 * @param reads the number of reads processed
+	 * @return the counts the time was added to, for adding cpu time
+	 */
+	StageCounts & add(uint32_t stage, uint32_t group, double wallSeconds,
+			uint64_t reads);
+
+	/**@brief time the running of func
+	 *
+	 * @param stage the stage id
+	 * @param group the group id
+	 * @param func the function to time
+	 * @param cpuTime whether to also record thread cpu time
+	 * @return whatever func returns
+	 */
+	template<typename FUNC>
+	auto time(uint32_t stage, uint32_t group, FUNC func, bool cpuTime = false) -> decltype(func()) {
+		Lap lap(*this, stage, group, 1, cpuTime);
+		return func();
+	}
+
+	/**@brief cpu time used by the calling thread so far
+	 *
+	 * @return seconds of cpu time
+	 */
+	static double threadCpuSeconds();
+
+	/**@brief the accumulated counts from all threads, should only be called once the recording threads are done
+	 *
+	 */
+	Json::Value toJson() const;
+
+	void writeJson(const OutOptions & outOpts) const;
+
+private:
+	/**@brief counts recorded by a single thread, key1 is group id, key2 is stage id
+	 *
+	 */
+	struct ThreadCounts {
+		std::vector<std::vector<StageCounts>> counts_;
+	};
+
+	uint64_t id_;
+	static std::atomic<uint64_t> nextId_;
+
+	mutable std::mutex mut_;
+	VecStr stageNames_;
+	std::unordered_map<std::string, uint32_t> stageIds_;
+	VecStr groupNames_;
+	std::unordered_map<std::string, uint32_t> groupIds_;
+	std::unordered_map<std::thread::id, std::unique_ptr<ThreadCounts>> threadCounts_;
+
+	ThreadCounts & localCounts();
+};
+
+}  // namespace njhseq
@@ -0,0 +1,14 @@
+#pragma once
+
+/*
+ * KmerUtils.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+
+
+#include "SeekDeep/objects/KmerUtils/PackedKmerSet.hpp"
+#include "SeekDeep/objects/KmerUtils/IncrementalKmerCounts.hpp"
+
+#include "SeekDeep/objects/KmerUtils/SeqCatalogIndex.hpp"
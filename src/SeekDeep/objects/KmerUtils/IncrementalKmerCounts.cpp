@@ -0,0 +1,179 @@
+/*
+ * IncrementalKmerCounts.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "IncrementalKmerCounts.hpp"
+
+namespace njhseq {
+
+IncrementalKmerCounts::IncrementalKmerCounts(
+		const IncrementalKmerCountsPars & pars) :
+		pars_(pars) {
+	if (0 == pars_.kLength_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error kLength_ should be at least 1" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+}
+
+void IncrementalKmerCounts::addSeq(const std::string & seq, int64_t countDelta,
+		KmerMaps & kMaps,
+		std::unordered_map<std::string, uint32_t> & touchedAnyWhere,
+		std::unordered_map<uint32_t, std::unordered_map<std::string, uint32_t>> & touchedByPos) const {
+	if (seq.size() < pars_.kLength_) {
+		return;
+	}
+	//a kmer with a count of 0 is removed from the map, same as if indexKmers had never seen it
+	auto applyDelta = [&countDelta](std::unordered_map<std::string, kmer> & kmers,
+			const std::string & k, uint32_t pos) {
+		auto search = kmers.find(k);
+		uint32_t previous = kmers.end() == search ? 0 : search->second.readCnt_;
+		auto current = static_cast<uint32_t>(std::max<int64_t>(0, static_cast<int64_t>(previous) + countDelta));
+		if (0 == current) {
+			if (kmers.end() != search) {
+				kmers.erase(search);
+			}
+		} else if (kmers.end() == search) {
+			kmers.emplace(k, kmer(k, pos, "", current));
+		} else {
+			search->second.readCnt_ = current;
+		}
+		return previous;
+	};
+	for (uint32_t pos = 0; pos + pars_.kLength_ <= seq.size(); ++pos) {
+		auto k = seq.substr(pos, pars_.kLength_);
+		{
+			auto previous = applyDelta(*kMaps.kmersAnyWhere_, k, 0);
+			touchedAnyWhere.emplace(k, previous);
+		}
+		uint32_t posStart = pos;
+		uint32_t posStop = pos;
+		if (pars_.expandKmerPos_) {
+			posStart = pos > pars_.expandKmerSize_ ? pos - pars_.expandKmerSize_ : 0;
+			posStop = pos + pars_.expandKmerSize_;
+		}
+		for (uint32_t kPos = posStart; kPos <= posStop; ++kPos) {
+			auto previous = applyDelta((*kMaps.kmersByPos_)[kPos], k, kPos);
+			touchedByPos[kPos].emplace(k, previous);
+		}
+	}
+}
+
+uint32_t IncrementalKmerCounts::update(
+		const std::unordered_map<std::string, uint32_t> & currentCounts,
+		KmerMaps & kMaps) {
+	changedAnyWhere_.clear();
+	changedByPos_.clear();
+	//the kmers whose count changed, with their count before the update
+	std::unordered_map<std::string, uint32_t> touchedAnyWhere;
+	std::unordered_map<uint32_t, std::unordered_map<std::string, uint32_t>> touchedByPos;
+	uint32_t seqsRecounted = 0;
+	for (const auto & current : currentCounts) {
+		auto previous = seqCounts_.find(current.first);
+		uint32_t previousCount = seqCounts_.end() == previous ? 0 : previous->second;
+		if (previousCount != current.second) {
+			addSeq(current.first, static_cast<int64_t>(current.second) - static_cast<int64_t>(previousCount),
+					kMaps, touchedAnyWhere, touchedByPos);
+			++seqsRecounted;
+		}
+	}
+	for (const auto & previous : seqCounts_) {
+		if (currentCounts.end() == currentCounts.find(previous.first)) {
+			addSeq(previous.first, -static_cast<int64_t>(previous.second),
+					kMaps, touchedAnyWhere, touchedByPos);
+			++seqsRecounted;
+		}
+	}
+	seqCounts_ = currentCounts;
+	//a kmer not in the map counts as 0 which is always low frequency
+	for (const auto & touched : touchedAnyWhere) {
+		auto search = kMaps.kmersAnyWhere_->find(touched.first);
+		uint32_t current = kMaps.kmersAnyWhere_->end() == search ? 0 : search->second.readCnt_;
+		if ((touched.second <= pars_.runCutOff_) != (current <= pars_.runCutOff_)) {
+			changedAnyWhere_.emplace(touched.first);
+		}
+	}
+	for (const auto & touchedPos : touchedByPos) {
+		const auto & posKmers = (*kMaps.kmersByPos_)[touchedPos.first];
+		for (const auto & touched : touchedPos.second) {
+			auto search = posKmers.find(touched.first);
+			uint32_t current = posKmers.end() == search ? 0 : search->second.readCnt_;
+			if ((touched.second <= pars_.runCutOff_) != (current <= pars_.runCutOff_)) {
+				changedByPos_[touchedPos.first].emplace(touched.first);
+			}
+		}
+	}
+	return seqsRecounted;
+}
+
+bool IncrementalKmerCounts::statusChanged() const {
+	return pars_.kmersByPosition_ ? !changedByPos_.empty() : !changedAnyWhere_.empty();
+}
+
+bool IncrementalKmerCounts::sameCounts(const KmerMaps & expected,
+		const KmerMaps & actual, std::ostream & diffs) {
+	bool same = true;
+	auto compareKmers = [&diffs,&same](const std::unordered_map<std::string, kmer> & expectedKmers,
+			const std::unordered_map<std::string, kmer> * actualKmers, const std::string & where) {
+		for (const auto & k : expectedKmers) {
+			uint32_t actualCount = 0;
+			if (nullptr != actualKmers) {
+				auto search = actualKmers->find(k.first);
+				actualCount = actualKmers->end() == search ? 0 : search->second.readCnt_;
+			}
+			if (actualCount != k.second.readCnt_) {
+				same = false;
+				diffs << where << "\t" << k.first << "\texpected: " << k.second.readCnt_ << "\tactual: " << actualCount << "\n";
+			}
+		}
+		if (nullptr != actualKmers) {
+			for (const auto & k : *actualKmers) {
+				if (k.second.readCnt_ > 0 && expectedKmers.end() == expectedKmers.find(k.first)) {
+					same = false;
+					diffs << where << "\t" << k.first << "\texpected: 0\tactual: " << k.second.readCnt_ << "\n";
+				}
+			}
+		}
+	};
+	compareKmers(*expected.kmersAnyWhere_, actual.kmersAnyWhere_.get(), "anywhere");
+	for (const auto & pos : *expected.kmersByPos_) {
+		auto search = actual.kmersByPos_->find(pos.first);
+		compareKmers(pos.second,
+				actual.kmersByPos_->end() == search ? nullptr : &search->second,
+				"pos " + estd::to_string(pos.first));
+	}
+	for (const auto & pos : *actual.kmersByPos_) {
+		if (expected.kmersByPos_->end() == expected.kmersByPos_->find(pos.first)) {
+			for (const auto & k : pos.second) {
+				if (k.second.readCnt_ > 0) {
+					same = false;
+					diffs << "pos " << pos.first << "\t" << k.first << "\texpected: 0\tactual: " << k.second.readCnt_ << "\n";
+				}
+			}
+		}
+	}
+	return same;
+}
+
+}  // namespace njhseq
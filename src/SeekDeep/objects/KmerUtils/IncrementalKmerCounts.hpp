@@ -0,0 +1,118 @@
+#pragma once
+/*
+ * IncrementalKmerCounts.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include <njhseq/common.h>
+#include <njhseq/alignment/aligner/aligner.hpp>
+
+namespace njhseq {
+
+/**@brief Updates the read count weighted kmer frequencies of a KmerMaps in place as the read counts of the sequences change rather than re-indexing
+ *
+ * Only the read count of each unique sequence is kept, the kmer counts themselves are only in the KmerMaps, so an update only touches the
+ * kmers of the sequences whose total read count changed. The kmers whose low frequency status changed across an update are kept so callers
+ * can tell whether anything that depends on the kmer frequencies needs to be redone
+ *
+ */
+class IncrementalKmerCounts {
+public:
+	struct IncrementalKmerCountsPars {
+		uint32_t kLength_{5};
+		uint32_t runCutOff_{1};
+		bool kmersByPosition_{true};
+		bool expandKmerPos_{false};
+		uint32_t expandKmerSize_{5};
+	};
+
+	IncrementalKmerCounts(const IncrementalKmerCountsPars & pars);
+
+	IncrementalKmerCountsPars pars_;
+
+	std::unordered_set<std::string> changedAnyWhere_; /**< kmers whose low frequency status changed in the last update*/
+	std::unordered_map<uint32_t, std::unordered_set<std::string>> changedByPos_; /**< kmers by position whose low frequency status changed in the last update*/
+
+	/**@brief record the read counts the kmer maps were indexed with, later updates apply the difference from these
+	 *
+	 * @param reads the reads given to indexKmers, each one counted with its rounded cnt_ same as indexKmers
+	 */
+	template<typename T>
+	void setBaseline(const std::vector<T> & reads) {
+		seqCounts_ = genSeqCounts(reads);
+	}
+
+	/**@brief update kMaps to the current state of reads, only the kmers of sequences whose total read count changed since the last update are touched
+	 *
+	 * @param reads the reads, each one counted with its rounded cnt_ same as indexKmers
+	 * @param kMaps the kmer maps generated by indexKmers with the reads given to setBaseline (or kept up to date by update since)
+	 * @return the number of unique sequences re-counted
+	 */
+	template<typename T>
+	uint32_t update(const std::vector<T> & reads, KmerMaps & kMaps) {
+		return update(genSeqCounts(reads), kMaps);
+	}
+
+	/**@brief update kMaps to the given read counts of each unique sequence
+	 *
+	 * @param currentCounts the total read count of each unique sequence
+	 * @param kMaps the kmer maps to update
+	 * @return the number of unique sequences re-counted
+	 */
+	uint32_t update(const std::unordered_map<std::string, uint32_t> & currentCounts, KmerMaps & kMaps);
+
+	/**@brief whether any kmer changed low frequency status in the last update
+	 *
+	 */
+	bool statusChanged() const;
+
+	/**@brief compare the read counts of every kmer in two kmer maps
+	 *
+	 * @param expected the expected counts, e.g. from indexKmers
+	 * @param actual the counts to check
+	 * @param diffs the kmers whose counts differ are written here
+	 * @return whether all the counts match
+	 */
+	static bool sameCounts(const KmerMaps & expected, const KmerMaps & actual, std::ostream & diffs);
+
+private:
+	std::unordered_map<std::string, uint32_t> seqCounts_;
+
+	template<typename T>
+	static std::unordered_map<std::string, uint32_t> genSeqCounts(const std::vector<T> & reads) {
+		std::unordered_map<std::string, uint32_t> ret;
+		for (const auto & read : reads) {
+			ret[getSeqBase(read).seq_] += static_cast<uint32_t>(std::round(getSeqBase(read).cnt_));
+		}
+		return ret;
+	}
+
+	/**@brief add countDelta to the counts of the kmers of seq in kMaps, recording the count each touched kmer had before this update
+	 *
+	 */
+	void addSeq(const std::string & seq, int64_t countDelta, KmerMaps & kMaps,
+			std::unordered_map<std::string, uint32_t> & touchedAnyWhere,
+			std::unordered_map<uint32_t, std::unordered_map<std::string, uint32_t>> & touchedByPos) const;
+};
+
+}  // namespace njhseq
@@ -0,0 +1,159 @@
+/*
+ * PackedKmerSet.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "PackedKmerSet.hpp"
+
+namespace njhseq {
+
+PackedKmerSet::PackedKmerSet(const std::string & seq, uint32_t kLen,
+		bool setRevComp) :
+		kLen_(kLen), seqLen_(seq.size()), revCompSet_(setRevComp) {
+	if (0 == kLen_ || kLen_ > 32) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error kLen_ should be between 1 and 32, not "
+				<< kLen_ << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	index(seq, kmers_, unpackableKmers_);
+	if (setRevComp) {
+		index(seqUtil::reverseComplement(seq, "DNA"), kmersRevComp_, unpackableKmersRevComp_);
+	}
+}
+
+bool PackedKmerSet::encodeBase(char base, uint64_t & code) {
+	switch (base) {
+	case 'A':
+		code = 0;
+		return true;
+	case 'C':
+		code = 1;
+		return true;
+	case 'G':
+		code = 2;
+		return true;
+	case 'T':
+		code = 3;
+		return true;
+	default:
+		return false;
+	}
+}
+
+void PackedKmerSet::index(const std::string & seq,
+		std::vector<uint64_t> & packed, VecStr & unpackable) const {
+	if (seq.size() < kLen_) {
+		return;
+	}
+	const uint64_t mask = 32 == kLen_ ? std::numeric_limits<uint64_t>::max() : (uint64_t(1) << (2 * kLen_)) - 1;
+	packed.reserve(seq.size() - kLen_ + 1);
+	uint64_t current = 0;
+	//position of the last base that couldn't be encoded, kmers overlapping it go to unpackable
+	int64_t lastBadPos = -1;
+	for (uint32_t pos = 0; pos < seq.size(); ++pos) {
+		uint64_t code = 0;
+		if (!encodeBase(seq[pos], code)) {
+			lastBadPos = pos;
+		}
+		current = ((current << 2) | code) & mask;
+		if (pos + 1 >= kLen_) {
+			uint32_t kStart = pos + 1 - kLen_;
+			if (lastBadPos >= static_cast<int64_t>(kStart)) {
+				unpackable.emplace_back(seq.substr(kStart, kLen_));
+			} else {
+				packed.emplace_back(current);
+			}
+		}
+	}
+	std::sort(packed.begin(), packed.end());
+	std::sort(unpackable.begin(), unpackable.end());
+}
+
+std::pair<uint32_t, double> PackedKmerSet::compareKmers(
+		const PackedKmerSet & other) const {
+	return compare(other.kmers_, other.unpackableKmers_, other.seqLen_, other.kLen_);
+}
+
+std::pair<uint32_t, double> PackedKmerSet::compareKmersRevComp(
+		const PackedKmerSet & other) const {
+	if (!other.revCompSet_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__
+				<< ", error other wasn't constructed with its reverse complement set"
+				<< "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	return compare(other.kmersRevComp_, other.unpackableKmersRevComp_,
+			other.seqLen_, other.kLen_);
+}
+
+std::pair<uint32_t, double> PackedKmerSet::compare(
+		const std::vector<uint64_t> & otherKmers, const VecStr & otherUnpackable,
+		uint32_t otherSeqLen, uint32_t otherKLen) const {
+	if (otherKLen != kLen_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error kmer lengths don't match, " << kLen_
+				<< " vs " << otherKLen << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	uint32_t minLen = std::min(seqLen_, otherSeqLen);
+	if (minLen < kLen_) {
+		return {0, 0.0};
+	}
+	//both are sorted with duplicates so a merge gives the sum of the minimum counts of each shared kmer
+	uint32_t kmersShared = 0;
+	{
+		auto thisIter = kmers_.begin();
+		auto otherIter = otherKmers.begin();
+		while (thisIter != kmers_.end() && otherIter != otherKmers.end()) {
+			if (*thisIter < *otherIter) {
+				++thisIter;
+			} else if (*otherIter < *thisIter) {
+				++otherIter;
+			} else {
+				++kmersShared;
+				++thisIter;
+				++otherIter;
+			}
+		}
+	}
+	if (!unpackableKmers_.empty() && !otherUnpackable.empty()) {
+		auto thisIter = unpackableKmers_.begin();
+		auto otherIter = otherUnpackable.begin();
+		while (thisIter != unpackableKmers_.end() && otherIter != otherUnpackable.end()) {
+			if (*thisIter < *otherIter) {
+				++thisIter;
+			} else if (*otherIter < *thisIter) {
+				++otherIter;
+			} else {
+				++kmersShared;
+				++thisIter;
+				++otherIter;
+			}
+		}
+	}
+	return {kmersShared, kmersShared / static_cast<double>(minLen - kLen_ + 1)};
+}
+
+}  // namespace njhseq
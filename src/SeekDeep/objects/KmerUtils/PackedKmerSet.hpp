@@ -0,0 +1,84 @@
+#pragma once
+/*
+ * PackedKmerSet.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include <njhseq/common.h>
+#include <njhseq/IO/SeqIO.h>
+
+namespace njhseq {
+
+/**@brief A light weight replacement for kmerInfo when only kmer sharing is needed,
+ * kmers are 2bit packed into 64bit integers and kept sorted so that comparisons are a single merge
+ *
+ * Kmers containing anything other than upper case A,C,G,T can't be packed and are kept as strings so
+ * comparisons give the same answer as kmerInfo::compareKmers/compareKmersRevComp
+ *
+ */
+class PackedKmerSet {
+public:
+	/**@brief construct from a sequence
+	 *
+	 * @param seq the sequence to index
+	 * @param kLen the kmer length, has to be between 1 and 32
+	 * @param setRevComp whether to also index the reverse complement of seq
+	 */
+	PackedKmerSet(const std::string & seq, uint32_t kLen, bool setRevComp);
+
+	uint32_t kLen_;
+	uint32_t seqLen_;
+	bool revCompSet_{false};
+
+	std::vector<uint64_t> kmers_; /**< sorted packed kmers, duplicates kept so counts are preserved*/
+	std::vector<uint64_t> kmersRevComp_;/**< sorted packed kmers of the reverse complement*/
+
+	VecStr unpackableKmers_; /**< sorted kmers that contained non ACGT characters*/
+	VecStr unpackableKmersRevComp_;
+
+	/**@brief compare the kmers of this set to the kmers of other
+	 *
+	 * @param other the other set
+	 * @return number of kmers shared and the fraction that is out of the kmers possible in the shorter sequence
+	 */
+	std::pair<uint32_t, double> compareKmers(const PackedKmerSet & other) const;
+
+	/**@brief compare the kmers of this set to the reverse complement kmers of other
+	 *
+	 * @param other the other set, has to have been constructed with setRevComp
+	 * @return number of kmers shared and the fraction that is out of the kmers possible in the shorter sequence
+	 */
+	std::pair<uint32_t, double> compareKmersRevComp(const PackedKmerSet & other) const;
+
+	static bool encodeBase(char base, uint64_t & code);
+
+
+private:
+	void index(const std::string & seq, std::vector<uint64_t> & packed,
+			VecStr & unpackable) const;
+
+	std::pair<uint32_t, double> compare(const std::vector<uint64_t> & otherKmers,
+			const VecStr & otherUnpackable, uint32_t otherSeqLen, uint32_t otherKLen) const;
+};
+
+}  // namespace njhseq
@@ -0,0 +1,128 @@
+/*
+ * SeqCatalogIndex.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "SeqCatalogIndex.hpp"
+#include "PackedKmerSet.hpp"
+
+namespace njhseq {
+
+SeqCatalogIndex::SeqCatalogIndex(const VecStr & seqs, uint32_t kLen) :
+		kLen_(kLen) {
+	if (0 == kLen_ || kLen_ > 32) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error kLen_ should be between 1 and 32, not "
+				<< kLen_ << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	lengths_.reserve(seqs.size());
+	std::unordered_map<uint64_t, uint32_t> counts;
+	for (uint32_t pos = 0; pos < seqs.size(); ++pos) {
+		lengths_.emplace_back(seqs[pos].size());
+		exactIndex_.emplace(seqs[pos], pos);
+		counts.clear();
+		if (!countKmers(seqs[pos], counts)) {
+			unindexable_.emplace_back(pos);
+			continue;
+		}
+		for (const auto & count : counts) {
+			kmerIndex_[count.first].emplace_back(pos, count.second);
+		}
+	}
+}
+
+uint32_t SeqCatalogIndex::size() const {
+	return lengths_.size();
+}
+
+bool SeqCatalogIndex::countKmers(const std::string & seq,
+		std::unordered_map<uint64_t, uint32_t> & counts) const {
+	const uint64_t mask = 32 == kLen_ ? std::numeric_limits<uint64_t>::max() : (uint64_t(1) << (2 * kLen_)) - 1;
+	uint64_t current = 0;
+	for (uint32_t pos = 0; pos < seq.size(); ++pos) {
+		uint64_t code = 0;
+		if (!PackedKmerSet::encodeBase(seq[pos], code)) {
+			return false;
+		}
+		current = ((current << 2) | code) & mask;
+		if (pos + 1 >= kLen_) {
+			++counts[current];
+		}
+	}
+	return true;
+}
+
+int64_t SeqCatalogIndex::getExactMatch(const std::string & seq) const {
+	auto search = exactIndex_.find(seq);
+	if (exactIndex_.end() == search) {
+		return -1;
+	}
+	return search->second;
+}
+
+std::vector<uint32_t> SeqCatalogIndex::getCandidates(const std::string & seq,
+		uint32_t maxEdits) const {
+	std::vector<uint32_t> ret;
+	std::unordered_map<uint64_t, uint32_t> seqCounts;
+	//the most kmers the edits could remove, anything that short could share no kmers at all and still pass
+	const uint64_t removable = static_cast<uint64_t>(kLen_) * maxEdits;
+	if (!countKmers(seq, seqCounts) || seq.size() < kLen_ + removable) {
+		ret.resize(lengths_.size());
+		njh::iota<uint32_t>(ret, 0);
+		return ret;
+	}
+	std::unordered_map<uint32_t, uint32_t> shared;
+	for (const auto & count : seqCounts) {
+		auto search = kmerIndex_.find(count.first);
+		if (kmerIndex_.end() != search) {
+			for (const auto & catalogCount : search->second) {
+				shared[catalogCount.first] += std::min(count.second, catalogCount.second);
+			}
+		}
+	}
+	std::vector<bool> isCandidate(lengths_.size(), false);
+	for (const auto pos : unindexable_) {
+		isCandidate[pos] = true;
+	}
+	for (uint32_t pos = 0; pos < lengths_.size(); ++pos) {
+		uint32_t shorterLen = std::min<uint32_t>(lengths_[pos], seq.size());
+		if (shorterLen < kLen_ + removable) {
+			isCandidate[pos] = true;
+		}
+	}
+	for (const auto & sharedCount : shared) {
+		uint64_t shorterLen = std::min<uint32_t>(lengths_[sharedCount.first], seq.size());
+		if (sharedCount.second + removable >= shorterLen - kLen_ + 1) {
+			isCandidate[sharedCount.first] = true;
+		}
+	}
+	for (uint32_t pos = 0; pos < isCandidate.size(); ++pos) {
+		if (isCandidate[pos]) {
+			ret.emplace_back(pos);
+		}
+	}
+	return ret;
+}
+
+}  // namespace njhseq
@@ -0,0 +1,82 @@
+#pragma once
+/*
+ * SeqCatalogIndex.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include <njhseq/common.h>
+
+namespace njhseq {
+
+/**@brief An index of a catalog of sequences (e.g. previously named haplotypes) for finding exact matches by hash and
+ * possible near matches by shared kmers
+ *
+ * Near match candidates come from the q-gram lemma applied to the shorter of each pair, two sequences within e internal edits of each other
+ * share at least min length - k + 1 - k * e kmers, so every catalog sequence that could be within the edits is returned whether or not end gaps are counted
+ *
+ */
+class SeqCatalogIndex {
+public:
+	/**@brief build the index
+	 *
+	 * @param seqs the catalog sequences
+	 * @param kLen the kmer length, has to be between 1 and 32
+	 */
+	SeqCatalogIndex(const VecStr & seqs, uint32_t kLen);
+
+	uint32_t kLen_;
+
+	/**@brief find a catalog sequence identical to seq
+	 *
+	 * @param seq the sequence
+	 * @return the position of the first identical catalog sequence, -1 if there isn't one
+	 */
+	int64_t getExactMatch(const std::string & seq) const;
+
+	/**@brief get every catalog sequence that could be within maxEdits of seq
+	 *
+	 * @param seq the sequence
+	 * @param maxEdits the most edits allowed
+	 * @return positions of the candidates in the catalog, in catalog order
+	 */
+	std::vector<uint32_t> getCandidates(const std::string & seq, uint32_t maxEdits) const;
+
+	uint32_t size() const;
+
+private:
+	std::vector<uint32_t> lengths_;
+	std::unordered_map<std::string, uint32_t> exactIndex_;
+	//for each packed kmer the catalog sequences it is in and how many times
+	std::unordered_map<uint64_t, std::vector<std::pair<uint32_t, uint32_t>>> kmerIndex_;
+	std::vector<uint32_t> unindexable_; /**< catalog sequences with non ACGT bases, always candidates*/
+
+	/**@brief count each distinct packed kmer in seq
+	 *
+	 * @param seq the sequence
+	 * @param counts the kmer counts
+	 * @return false if seq has non ACGT bases
+	 */
+	bool countKmers(const std::string & seq, std::unordered_map<uint64_t, uint32_t> & counts) const;
+};
+
+}  // namespace njhseq
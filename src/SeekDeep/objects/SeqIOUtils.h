@@ -0,0 +1,14 @@
+#pragma once
+
+/*
+ * SeqIOUtils.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+
+
+#include "SeekDeep/objects/SeqIOUtils/MultiSeqOutPool.hpp"
+
+#include "SeekDeep/objects/SeqIOUtils/StreamingTableConcatenator.hpp"
+#include "SeekDeep/objects/SeqIOUtils/ParallelGzipWriter.hpp"
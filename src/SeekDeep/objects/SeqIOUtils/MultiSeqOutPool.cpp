@@ -0,0 +1,197 @@
+/*
+ * MultiSeqOutPool.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "MultiSeqOutPool.hpp"
+
+namespace njhseq {
+
+MultiSeqOutPool::Writer::Writer(const SeqIOOptions & opts) :
+		opts_(opts),
+		gz_(njh::endsWith(opts.out_.outFilename_.string(), ".gz")
+				|| njh::endsWith(opts.out_.outExtention_, ".gz")) {
+}
+
+bool MultiSeqOutPool::Writer::bufferEmpty() const {
+	return seqBuffer_.empty() && pairBuffer_.empty();
+}
+
+MultiSeqOutPool::MultiSeqOutPool() :
+		MultiSeqOutPool(PoolPars { }) {
+}
+
+MultiSeqOutPool::MultiSeqOutPool(const PoolPars & pars) :
+		pars_(pars) {
+	if (0 == pars_.maxOpen_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error maxOpen_ should be greater than 0"
+				<< "\n";
+		throw std::runtime_error { ss.str() };
+	}
+}
+
+MultiSeqOutPool::~MultiSeqOutPool() {
+	try {
+		closeOutAll();
+	} catch (const std::exception & e) {
+		std::cerr << __PRETTY_FUNCTION__ << ", error in closing outputs: "
+				<< e.what() << std::endl;
+	}
+}
+
+void MultiSeqOutPool::addReader(const std::string & uid,
+		const SeqIOOptions & opts) {
+	if (containsReader(uid)) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error already contains " << uid << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	writers_.emplace(uid, Writer(opts));
+}
+
+bool MultiSeqOutPool::containsReader(const std::string & uid) const {
+	return writers_.end() != writers_.find(uid);
+}
+
+MultiSeqOutPool::Writer & MultiSeqOutPool::getWriter(const std::string & uid,
+		const std::string & funcName) {
+	auto search = writers_.find(uid);
+	if (writers_.end() == search) {
+		std::stringstream ss;
+		ss << funcName << ", error no output for " << uid << "\n";
+		ss << "Options are: " << njh::conToStr(getVectorOfMapKeys(writers_), ", ")
+				<< "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	return search->second;
+}
+
+void MultiSeqOutPool::openWrite(const std::string & uid, const seqInfo & seq) {
+	auto & writer = getWriter(uid, __PRETTY_FUNCTION__);
+	writer.seqBuffer_.emplace_back(seq);
+	if (writer.seqBuffer_.size() >= pars_.bufferSize_) {
+		flush(uid);
+	}
+}
+
+void MultiSeqOutPool::openWrite(const std::string & uid,
+		const readObject & seq) {
+	openWrite(uid, seq.seqBase_);
+}
+
+void MultiSeqOutPool::openWrite(const std::string & uid,
+		const PairedRead & seq) {
+	auto & writer = getWriter(uid, __PRETTY_FUNCTION__);
+	writer.pairBuffer_.emplace_back(seq);
+	if (writer.pairBuffer_.size() >= pars_.bufferSize_) {
+		flush(uid);
+	}
+}
+
+void MultiSeqOutPool::flush(const std::string & uid) {
+	auto & writer = getWriter(uid, __PRETTY_FUNCTION__);
+	if (writer.bufferEmpty()) {
+		return;
+	}
+	makeOpen(uid);
+	writeBuffer(writer);
+}
+
+void MultiSeqOutPool::writeBuffer(Writer & writer) {
+	for (const auto & seq : writer.seqBuffer_) {
+		writer.out_->write(seq);
+	}
+	writer.seqBuffer_.clear();
+	for (const auto & seq : writer.pairBuffer_) {
+		writer.out_->write(seq);
+	}
+	writer.pairBuffer_.clear();
+}
+
+void MultiSeqOutPool::makeOpen(const std::string & uid) {
+	auto & writer = writers_.at(uid);
+	if (writer.gz_) {
+		//gzipped outputs are opened once and left open, appending would start a second gzip member
+		if (nullptr == writer.out_) {
+			writer.out_ = std::make_unique<SeqOutput>(writer.opts_);
+			writer.out_->openOut();
+			writer.beenOpened_ = true;
+			++gzOpenCount_;
+		}
+		return;
+	}
+	auto search = openPositions_.find(uid);
+	if (openPositions_.end() != search) {
+		//already open, just move to the front of the line
+		openOrder_.splice(openOrder_.begin(), openOrder_, search->second);
+		return;
+	}
+	while (openOrder_.size() >= pars_.maxOpen_) {
+		closeWriter(openOrder_.back());
+	}
+	if (writer.beenOpened_) {
+		//already written to once so add on to what's there rather than starting over
+		writer.opts_.out_.append_ = true;
+		writer.opts_.out_.overWriteFile_ = false;
+	}
+	writer.out_ = std::make_unique<SeqOutput>(writer.opts_);
+	writer.out_->openOut();
+	writer.beenOpened_ = true;
+	openOrder_.emplace_front(uid);
+	openPositions_[uid] = openOrder_.begin();
+}
+
+void MultiSeqOutPool::closeWriter(const std::string & uid) {
+	auto & writer = writers_.at(uid);
+	if (nullptr != writer.out_) {
+		if (!writer.bufferEmpty()) {
+			writeBuffer(writer);
+		}
+		writer.out_->closeOut();
+		writer.out_ = nullptr;
+		if (writer.gz_) {
+			--gzOpenCount_;
+		}
+	}
+	auto search = openPositions_.find(uid);
+	if (openPositions_.end() != search) {
+		openOrder_.erase(search->second);
+		openPositions_.erase(search);
+	}
+}
+
+void MultiSeqOutPool::closeOutAll() {
+	for (auto & writer : writers_) {
+		if (!writer.second.bufferEmpty()) {
+			flush(writer.first);
+		}
+		closeWriter(writer.first);
+	}
+}
+
+uint32_t MultiSeqOutPool::getOpenCount() const {
+	return openOrder_.size() + gzOpenCount_;
+}
+
+}  // namespace njhseq
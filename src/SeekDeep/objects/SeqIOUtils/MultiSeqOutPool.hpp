@@ -0,0 +1,105 @@
+#pragma once
+/*
+ * MultiSeqOutPool.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include <njhseq/common.h>
+#include <njhseq/IO/SeqIO.h>
+
+namespace njhseq {
+
+/**@brief A drop in for MultiSeqIO when writing to a lot of outputs, sequences are buffered per output and written
+ * in blocks and only a limited number of files are kept open at once, the least recently used file is closed when the
+ * limit is reached and re-opened in append mode when needed again
+ *
+ * Gzipped outputs are never closed early, re-opening them in append mode would start a second gzip member, so once opened they stay
+ * open until closeOutAll() and don't count towards maxOpen_
+ *
+ * Like MultiSeqIO a file is only created once something is written to it
+ *
+ */
+class MultiSeqOutPool {
+public:
+	struct PoolPars {
+		uint32_t maxOpen_ { 200 }; /**< the maximum number of files to have open at once*/
+		uint32_t bufferSize_ { 1000 }; /**< the number of sequences to hold per output before writing*/
+	};
+
+	MultiSeqOutPool();
+	explicit MultiSeqOutPool(const PoolPars & pars);
+
+	~MultiSeqOutPool();
+
+	void addReader(const std::string & uid, const SeqIOOptions & opts);
+	bool containsReader(const std::string & uid) const;
+
+	void openWrite(const std::string & uid, const seqInfo & seq);
+	void openWrite(const std::string & uid, const readObject & seq);
+	void openWrite(const std::string & uid, const PairedRead & seq);
+
+	template<typename T>
+	void openWrite(const std::string & uid, const std::shared_ptr<T> & seq) {
+		openWrite(uid, *seq);
+	}
+
+	/**@brief write out any buffered sequences for this output, will open the file if needed
+	 *
+	 * @param uid the output to flush
+	 */
+	void flush(const std::string & uid);
+
+	/**@brief write out all buffered sequences and close all files
+	 *
+	 */
+	void closeOutAll();
+
+	uint32_t getOpenCount() const;
+
+private:
+	struct Writer {
+		explicit Writer(const SeqIOOptions & opts);
+		SeqIOOptions opts_;
+		std::unique_ptr<SeqOutput> out_;
+		bool beenOpened_ { false };
+		bool gz_ { false }; /**< whether this is a gzipped output, which are kept open*/
+		std::vector<seqInfo> seqBuffer_;
+		std::vector<PairedRead> pairBuffer_;
+
+		bool bufferEmpty() const;
+	};
+
+	PoolPars pars_;
+	std::unordered_map<std::string, Writer> writers_;
+
+	std::list<std::string> openOrder_; /**< open outputs, most recently used first*/
+	std::unordered_map<std::string, std::list<std::string>::iterator> openPositions_;
+	uint32_t gzOpenCount_ { 0 };
+
+	Writer & getWriter(const std::string & uid, const std::string & funcName);
+	void makeOpen(const std::string & uid);
+	void writeBuffer(Writer & writer);
+	void closeWriter(const std::string & uid);
+};
+
+}  // namespace njhseq
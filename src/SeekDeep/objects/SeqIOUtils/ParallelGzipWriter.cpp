@@ -0,0 +1,304 @@
+/*
+ * ParallelGzipWriter.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "ParallelGzipWriter.hpp"
+
+#include <zlib.h>
+#include <cstring>
+
+namespace njhseq {
+
+ParallelGzipWriter::BlockBuf::BlockBuf(ParallelGzipWriter & owner,
+		uint32_t blockSize) :
+		owner_(owner), buffer_(blockSize) {
+	setp(buffer_.data(), buffer_.data() + buffer_.size());
+}
+
+void ParallelGzipWriter::BlockBuf::submitBlock() {
+	if (pptr() > pbase()) {
+		owner_.addBlock(std::string(pbase(), pptr()));
+		setp(buffer_.data(), buffer_.data() + buffer_.size());
+	}
+}
+
+ParallelGzipWriter::BlockBuf::int_type ParallelGzipWriter::BlockBuf::overflow(
+		int_type ch) {
+	submitBlock();
+	if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+		*pptr() = traits_type::to_char_type(ch);
+		pbump(1);
+	}
+	return traits_type::not_eof(ch);
+}
+
+ParallelGzipWriter::CompressPool::CompressPool(uint32_t numThreads) {
+	for (uint32_t t = 0; t < std::max<uint32_t>(1, numThreads); ++t) {
+		threads_.emplace_back([this]() {
+			runTasks();
+		});
+	}
+}
+
+ParallelGzipWriter::CompressPool::~CompressPool() {
+	{
+		std::lock_guard<std::mutex> lock(mut_);
+		done_ = true;
+	}
+	tasksChanged_.notify_all();
+	for (auto & t : threads_) {
+		t.join();
+	}
+}
+
+uint32_t ParallelGzipWriter::CompressPool::numThreads() const {
+	return threads_.size();
+}
+
+void ParallelGzipWriter::CompressPool::add(std::function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(mut_);
+		tasks_.emplace_back(std::move(task));
+	}
+	tasksChanged_.notify_one();
+}
+
+void ParallelGzipWriter::CompressPool::runTasks() {
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mut_);
+			tasksChanged_.wait(lock, [this]() {
+				return !tasks_.empty() || done_;
+			});
+			if (tasks_.empty()) {
+				return;
+			}
+			task = std::move(tasks_.front());
+			tasks_.pop_front();
+		}
+		task();
+	}
+}
+
+ParallelGzipWriter::ParallelGzipWriter(const OutOptions & outOpts,
+		const Pars & pars) :
+		ParallelGzipWriter(outOpts, pars, std::make_shared<CompressPool>(pars.numThreads_)) {
+}
+
+ParallelGzipWriter::ParallelGzipWriter(const OutOptions & outOpts,
+		const Pars & pars, const std::shared_ptr<CompressPool> & pool) :
+		std::ostream(nullptr), pars_(pars), pool_(pool), buf_(*this, std::max<uint32_t>(1, pars.blockSize_)) {
+	if (nullptr == pool_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error no compress pool given" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	if (bfs::exists(outOpts.outName()) && !outOpts.overWriteFile_ && !outOpts.append_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error " << outOpts.outName()
+				<< " already exists, use overwrite to over write it" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	file_.open(outOpts.outName().string(),
+			outOpts.append_ ? std::ios::binary | std::ios::app : std::ios::binary | std::ios::trunc);
+	if (!file_) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error opening " << outOpts.outName() << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	rdbuf(&buf_);
+	writerThread_ = std::thread([this]() {
+		writeBlocks();
+	});
+}
+
+ParallelGzipWriter::~ParallelGzipWriter() {
+	try {
+		finish();
+	} catch (std::exception & e) {
+		std::cerr << __PRETTY_FUNCTION__ << ", error writing gzip blocks: " << e.what() << std::endl;
+	}
+}
+
+void ParallelGzipWriter::addBlock(std::string block) {
+	uint64_t blockPos = 0;
+	{
+		std::unique_lock<std::mutex> lock(mut_);
+		//back pressure, only hold a couple of blocks per compressing thread in memory
+		stateChanged_.wait(lock, [this]() {
+			return blocksSubmitted_ - blocksWritten_ < 2 * pool_->numThreads() || nullptr != error_;
+		});
+		if (nullptr != error_) {
+			return;
+		}
+		blockPos = blocksSubmitted_;
+		++blocksSubmitted_;
+		++blocksCompressing_;
+	}
+	auto blockPtr = std::make_shared<std::string>(std::move(block));
+	pool_->add([this, blockPos, blockPtr]() {
+		compressBlockTask(blockPos, *blockPtr);
+	});
+}
+
+void ParallelGzipWriter::compressBlockTask(uint64_t blockPos,
+		const std::string & block) {
+	bool failed = false;
+	{
+		std::lock_guard<std::mutex> lock(mut_);
+		failed = nullptr != error_;
+	}
+	std::string member;
+	if (!failed) {
+		try {
+			member = compressBlock(block, pars_.compressionLevel_);
+		} catch (...) {
+			setError(std::current_exception());
+			failed = true;
+		}
+	}
+	std::lock_guard<std::mutex> lock(mut_);
+	if (!failed) {
+		compressed_.emplace(blockPos, std::move(member));
+	}
+	--blocksCompressing_;
+	stateChanged_.notify_all();
+}
+
+void ParallelGzipWriter::finish() {
+	if (finished_) {
+		return;
+	}
+	finished_ = true;
+	buf_.submitBlock();
+	//an empty file isn't valid gzip, write an empty member instead
+	if (0 == blocksSubmitted_) {
+		addBlock("");
+	}
+	{
+		std::unique_lock<std::mutex> lock(mut_);
+		done_ = true;
+		stateChanged_.notify_all();
+		//the pool's tasks refer to this writer so all of them have to be done before it can go
+		stateChanged_.wait(lock, [this]() {
+			return 0 == blocksCompressing_;
+		});
+	}
+	writerThread_.join();
+	file_.close();
+	if (nullptr != error_) {
+		std::rethrow_exception(error_);
+	}
+}
+
+void ParallelGzipWriter::setError(std::exception_ptr err) {
+	std::lock_guard<std::mutex> lock(mut_);
+	if (nullptr == error_) {
+		error_ = err;
+	}
+	stateChanged_.notify_all();
+}
+
+void ParallelGzipWriter::writeBlocks() {
+	while (true) {
+		std::string member;
+		{
+			std::unique_lock<std::mutex> lock(mut_);
+			stateChanged_.wait(lock, [this]() {
+				return compressed_.end() != compressed_.find(blocksWritten_) || nullptr != error_
+						|| (done_ && blocksWritten_ == blocksSubmitted_);
+			});
+			if (nullptr != error_ || blocksWritten_ == blocksSubmitted_) {
+				return;
+			}
+			member = std::move(compressed_[blocksWritten_]);
+			compressed_.erase(blocksWritten_);
+		}
+		file_.write(member.data(), member.size());
+		if (!file_) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error writing gzip block " << blocksWritten_ << "\n";
+			setError(std::make_exception_ptr(std::runtime_error { ss.str() }));
+			return;
+		}
+		std::lock_guard<std::mutex> lock(mut_);
+		++blocksWritten_;
+		stateChanged_.notify_all();
+	}
+}
+
+std::string ParallelGzipWriter::compressBlock(const std::string & block,
+		int32_t compressionLevel) {
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+	//15 + 16 gives a gzip header and trailer rather than zlib's
+	if (Z_OK != deflateInit2(&zs, compressionLevel, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY)) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error initializing zlib with compression level " << compressionLevel << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	std::string ret(deflateBound(&zs, block.size()), '\0');
+	zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(block.data()));
+	zs.avail_in = block.size();
+	zs.next_out = reinterpret_cast<Bytef*>(&ret[0]);
+	zs.avail_out = ret.size();
+	auto status = deflate(&zs, Z_FINISH);
+	while (Z_OK == status || Z_BUF_ERROR == status) {
+		//ran out of room, shouldn't happen given deflateBound but grow and keep going
+		auto written = zs.total_out;
+		ret.resize(ret.size() * 2 + 64);
+		zs.next_out = reinterpret_cast<Bytef*>(&ret[written]);
+		zs.avail_out = ret.size() - written;
+		status = deflate(&zs, Z_FINISH);
+	}
+	auto totalOut = zs.total_out;
+	deflateEnd(&zs);
+	if (Z_STREAM_END != status) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error compressing block, zlib status: " << status << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	ret.resize(totalOut);
+	return ret;
+}
+
+void ParallelGzipWriter::compressFile(const bfs::path & inFnp,
+		const OutOptions & outOpts, const Pars & pars,
+		const std::shared_ptr<CompressPool> & pool) {
+	std::ifstream inFile(inFnp.string(), std::ios::binary);
+	if (!inFile) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error opening " << inFnp << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	ParallelGzipWriter writer(outOpts, pars, nullptr == pool ? std::make_shared<CompressPool>(pars.numThreads_) : pool);
+	std::vector<char> buffer(std::max<uint32_t>(1, pars.blockSize_));
+	while (inFile.read(buffer.data(), buffer.size()) || inFile.gcount() > 0) {
+		writer.write(buffer.data(), inFile.gcount());
+	}
+	writer.finish();
+}
+
+}  // namespace njhseq
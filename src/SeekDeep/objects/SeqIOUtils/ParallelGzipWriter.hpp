@@ -0,0 +1,153 @@
+#pragma once
+/*
+ * ParallelGzipWriter.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include <njhseq/common.h>
+#include <njhseq/IO/IOUtils.hpp>
+
+#include <thread>
+#include <condition_variable>
+
+namespace njhseq {
+
+/**@brief A gzip output stream that compresses blocks in parallel
+ *
+ * Output is cut into fixed size blocks and each block is compressed into its own gzip member on a pool of threads,
+ * members are written in order by a writer thread. Concatenated gzip members are a valid gzip file so the output can be read
+ * with gunzip or any other gzip reader. Only full blocks are compressed while writing, flushing the stream doesn't cut a block short,
+ * the last partial block is written by finish(). Several writers can share one CompressPool so files written at the same time
+ * don't each start their own compressing threads
+ *
+ */
+class ParallelGzipWriter : public std::ostream {
+public:
+	struct Pars {
+		uint32_t numThreads_{1}; /**< only used when the writer makes its own pool*/
+		uint32_t blockSize_{1024 * 1024};
+		int32_t compressionLevel_{6};
+	};
+
+	/**@brief A set of threads that run compression tasks for any number of writers
+	 *
+	 */
+	class CompressPool {
+	public:
+		explicit CompressPool(uint32_t numThreads);
+		~CompressPool();
+
+		uint32_t numThreads() const;
+
+		void add(std::function<void()> task);
+
+	private:
+		std::mutex mut_;
+		std::condition_variable tasksChanged_;
+		std::deque<std::function<void()>> tasks_;
+		bool done_{false};
+		std::vector<std::thread> threads_;
+
+		void runTasks();
+	};
+
+	/**@brief open the output and start the writing thread and a pool of pars.numThreads_ compressing threads
+	 *
+	 * @param outOpts the output file, appending adds new gzip members to the end of the file
+	 * @param pars the number of threads, block size and compression level
+	 */
+	ParallelGzipWriter(const OutOptions & outOpts, const Pars & pars);
+
+	/**@brief open the output and start the writing thread, blocks are compressed on pool
+	 *
+	 * @param outOpts the output file, appending adds new gzip members to the end of the file
+	 * @param pars the block size and compression level
+	 * @param pool the compressing threads, can be shared with other writers
+	 */
+	ParallelGzipWriter(const OutOptions & outOpts, const Pars & pars,
+			const std::shared_ptr<CompressPool> & pool);
+
+	~ParallelGzipWriter();
+
+	/**@brief compress the last block, wait for all blocks to be written and close the file, will throw if compressing or writing failed
+	 *
+	 */
+	void finish();
+
+	/**@brief compress a block into a single gzip member
+	 *
+	 * @param block the data to compress
+	 * @param compressionLevel the zlib compression level
+	 * @return the gzip member
+	 */
+	static std::string compressBlock(const std::string & block, int32_t compressionLevel);
+
+	/**@brief gzip a file
+	 *
+	 * @param inFnp the file to compress
+	 * @param outOpts the gzipped output
+	 * @param pars the writing parameters
+	 * @param pool the compressing threads, if nullptr a pool of pars.numThreads_ is made for this file
+	 */
+	static void compressFile(const bfs::path & inFnp, const OutOptions & outOpts,
+			const Pars & pars, const std::shared_ptr<CompressPool> & pool = nullptr);
+
+private:
+	class BlockBuf : public std::streambuf {
+	public:
+		BlockBuf(ParallelGzipWriter & owner, uint32_t blockSize);
+
+		void submitBlock();
+
+	protected:
+		int_type overflow(int_type ch) override;
+
+	private:
+		ParallelGzipWriter & owner_;
+		std::vector<char> buffer_;
+	};
+
+	Pars pars_;
+	std::shared_ptr<CompressPool> pool_;
+	BlockBuf buf_;
+	std::ofstream file_;
+
+	std::mutex mut_;
+	std::condition_variable stateChanged_;
+	std::map<uint64_t, std::string> compressed_;
+	uint64_t blocksSubmitted_{0};
+	uint64_t blocksCompressing_{0}; /**< blocks handed to the pool that haven't finished, finish() waits on these since they refer to this writer*/
+	uint64_t blocksWritten_{0};
+	bool done_{false};
+	bool finished_{false};
+	std::exception_ptr error_;
+
+	std::thread writerThread_;
+
+	void addBlock(std::string block);
+	void compressBlockTask(uint64_t blockPos, const std::string & block);
+	void writeBlocks();
+	void setError(std::exception_ptr err);
+};
+
+}  // namespace njhseq
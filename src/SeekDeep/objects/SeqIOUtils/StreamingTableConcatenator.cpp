@@ -0,0 +1,241 @@
+/*
+ * StreamingTableConcatenator.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "StreamingTableConcatenator.hpp"
+
+#include <njhseq/IO/OutputStream.hpp>
+#include <njhseq/IO/InputStream.hpp>
+
+#include <numeric>
+#include <thread>
+#include <condition_variable>
+
+namespace njhseq {
+
+StreamingTableConcatenator::StreamingTableConcatenator(
+		const std::string & keyColumnName) :
+		keyColumnName_(keyColumnName) {
+}
+
+void StreamingTableConcatenator::addInput(const std::string & key,
+		const bfs::path & fnp) {
+	if (bfs::exists(fnp)) {
+		inputs_.emplace_back(Input { key, fnp });
+	}
+}
+
+VecStr StreamingTableConcatenator::splitLine(const std::string & line) {
+	//split by hand so empty columns, including trailing ones, are kept
+	VecStr ret;
+	std::string::size_type start = 0;
+	std::string::size_type tabPos = line.find('\t');
+	while (std::string::npos != tabPos) {
+		ret.emplace_back(line.substr(start, tabPos - start));
+		start = tabPos + 1;
+		tabPos = line.find('\t', start);
+	}
+	ret.emplace_back(line.substr(start));
+	return ret;
+}
+
+std::string StreamingTableConcatenator::formatRows(const Input & input,
+		const std::vector<uint32_t> & colPositions, uint64_t & rows) {
+	InputStream in(input.fnp_);
+	std::string line;
+	//skip the header, it was checked before reading any rows
+	njh::files::crossPlatGetline(in, line);
+	std::stringstream ret;
+	rows = 0;
+	while (njh::files::crossPlatGetline(in, line)) {
+		if (line.empty()) {
+			continue;
+		}
+		auto toks = splitLine(line);
+		ret << input.key_;
+		for (const auto colPos : colPositions) {
+			if (colPos >= toks.size()) {
+				std::stringstream ss;
+				ss << __PRETTY_FUNCTION__ << ", error row " << rows + 1 << " of "
+						<< input.fnp_ << " has " << toks.size()
+						<< " columns, less than the header" << "\n";
+				throw std::runtime_error { ss.str() };
+			}
+			ret << "\t" << toks[colPos];
+		}
+		ret << "\n";
+		++rows;
+	}
+	return ret.str();
+}
+
+uint64_t StreamingTableConcatenator::writeOut(const OutOptions & outOpts,
+		uint32_t numThreads, uint32_t maxReadAhead) const {
+	//sort positions on the keys only, stable so ties keep the order they were added in
+	std::vector<uint32_t> order(inputs_.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(),
+			[this](uint32_t first, uint32_t second) {
+				return inputs_[first].key_ < inputs_[second].key_;
+			});
+	if (order.empty()) {
+		return 0;
+	}
+	//check every header first so a mismatch throws before anything is written, the columns are put in the order of the first input
+	VecStr columnNames;
+	std::vector<std::vector<uint32_t>> colPositions(inputs_.size());
+	for (const auto pos : order) {
+		InputStream in(inputs_[pos].fnp_);
+		std::string header;
+		njh::files::crossPlatGetline(in, header);
+		auto currentColumnNames = splitLine(header);
+		if (columnNames.empty()) {
+			columnNames = currentColumnNames;
+		}
+		std::unordered_map<std::string, uint32_t> currentPositions;
+		for (uint32_t colPos = 0; colPos < currentColumnNames.size(); ++colPos) {
+			currentPositions.emplace(currentColumnNames[colPos], colPos);
+		}
+		bool matches = currentColumnNames.size() == columnNames.size() && currentPositions.size() == columnNames.size();
+		for (const auto & col : columnNames) {
+			auto search = currentPositions.find(col);
+			if (currentPositions.end() == search) {
+				matches = false;
+				break;
+			}
+			colPositions[pos].emplace_back(search->second);
+		}
+		if (!matches) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error the columns of "
+					<< inputs_[pos].fnp_ << " don't match the columns of "
+					<< inputs_[order.front()].fnp_ << "\n";
+			ss << "expected: " << njh::conToStr(columnNames, ",") << "\n";
+			ss << "found: " << njh::conToStr(currentColumnNames, ",") << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+	}
+
+	//inputs are read by the threads in key order into their own slot, at most maxReadAhead past the last one written
+	const uint32_t numReaders = std::max<uint32_t>(1, std::min<uint32_t>(numThreads, order.size()));
+	const uint64_t readAhead = 0 == maxReadAhead ? 2 * numReaders : maxReadAhead;
+	std::mutex mut;
+	std::condition_variable stateChanged;
+	std::vector<std::string> formatted(order.size());
+	std::vector<uint64_t> rowCounts(order.size(), 0);
+	std::vector<bool> ready(order.size(), false);
+	uint64_t nextToRead = 0;
+	uint64_t written = 0;
+	bool failed = false;
+	std::exception_ptr readError;
+	auto readInputs = [&]() {
+		while (true) {
+			uint64_t orderPos = 0;
+			{
+				std::unique_lock<std::mutex> lock(mut);
+				stateChanged.wait(lock, [&]() {
+					return failed || nextToRead >= order.size() || nextToRead < written + readAhead;
+				});
+				if (failed || nextToRead >= order.size()) {
+					return;
+				}
+				orderPos = nextToRead;
+				++nextToRead;
+			}
+			try {
+				uint64_t rows = 0;
+				auto rowsStr = formatRows(inputs_[order[orderPos]], colPositions[order[orderPos]], rows);
+				std::lock_guard<std::mutex> lock(mut);
+				formatted[orderPos] = std::move(rowsStr);
+				rowCounts[orderPos] = rows;
+				ready[orderPos] = true;
+			} catch (...) {
+				std::lock_guard<std::mutex> lock(mut);
+				if (nullptr == readError) {
+					readError = std::current_exception();
+				}
+				failed = true;
+			}
+			stateChanged.notify_all();
+		}
+	};
+	std::vector<std::thread> readers;
+	for (uint32_t threadNum = 0; threadNum < numReaders; ++threadNum) {
+		readers.emplace_back(readInputs);
+	}
+	auto stopReaders = [&]() {
+		{
+			std::lock_guard<std::mutex> lock(mut);
+			failed = true;
+		}
+		stateChanged.notify_all();
+		for (auto & reader : readers) {
+			reader.join();
+		}
+	};
+
+	uint64_t totalRows = 0;
+	//opened with the first row so nothing is written if there are no rows
+	std::unique_ptr<OutputStream> out;
+	try {
+		for (uint64_t orderPos = 0; orderPos < order.size(); ++orderPos) {
+			std::string rowsStr;
+			uint64_t rows = 0;
+			{
+				std::unique_lock<std::mutex> lock(mut);
+				stateChanged.wait(lock, [&]() {
+					return failed || ready[orderPos];
+				});
+				if (!ready[orderPos]) {
+					break;
+				}
+				rowsStr.swap(formatted[orderPos]);
+				rows = rowCounts[orderPos];
+			}
+			if (rows > 0) {
+				if (nullptr == out) {
+					out = std::make_unique<OutputStream>(outOpts);
+					(*out) << keyColumnName_ << "\t" << njh::conToStr(columnNames, "\t") << "\n";
+				}
+				(*out) << rowsStr;
+				totalRows += rows;
+			}
+			{
+				std::lock_guard<std::mutex> lock(mut);
+				++written;
+			}
+			stateChanged.notify_all();
+		}
+	} catch (...) {
+		stopReaders();
+		throw;
+	}
+	stopReaders();
+	if (nullptr != readError) {
+		std::rethrow_exception(readError);
+	}
+	return totalRows;
+}
+
+}  // namespace njhseq
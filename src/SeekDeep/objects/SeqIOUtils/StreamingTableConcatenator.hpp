@@ -0,0 +1,87 @@
+#pragma once
+/*
+ * StreamingTableConcatenator.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include <njhseq/common.h>
+#include <njhseq/IO/IOUtils.hpp>
+
+namespace njhseq {
+
+/**@brief Concatenates many tab delimited tables with the same columns into one output file, adding a key column to the front
+ *
+ * Only the keys are sorted, the inputs are then read and written out one at a time in key order and keep their original row order,
+ * so nothing is copied into an ever growing table. Inputs are read in parallel a bounded number ahead of the one being written,
+ * so at most that many inputs are held in memory at once.
+ *
+ */
+class StreamingTableConcatenator {
+public:
+	/**@brief construct with the name of the key column
+	 *
+	 * @param keyColumnName the name of the column added to the front of the output holding each input's key
+	 */
+	explicit StreamingTableConcatenator(const std::string & keyColumnName);
+
+	/**@brief add a table to be concatenated, files that don't exist are skipped
+	 *
+	 * @param key the value to put in the key column for every row of this table and to sort on
+	 * @param fnp the tab delimited table with a header
+	 */
+	void addInput(const std::string & key, const bfs::path & fnp);
+
+	/**@brief read all the inputs and write them out, nothing is written if no input had any rows
+	 *
+	 * Inputs are sorted by key (ties keep the order they were added in), the headers are all checked before any rows are read and
+	 * throws if an input's columns don't match the first input's
+	 *
+	 * @param outOpts the options for the output file
+	 * @param numThreads the number of threads to read inputs with, the calling thread writes
+	 * @param maxReadAhead the most inputs that can be read and waiting to be written, 0 for twice numThreads
+	 * @return the number of rows written
+	 */
+	uint64_t writeOut(const OutOptions & outOpts, uint32_t numThreads, uint32_t maxReadAhead = 0) const;
+
+private:
+	struct Input {
+		std::string key_;
+		bfs::path fnp_;
+	};
+	std::string keyColumnName_;
+	std::vector<Input> inputs_;
+
+	/**@brief read the rows of an input into the output format, the key followed by the columns in the given order
+	 *
+	 * @param input the input
+	 * @param colPositions the position in the input of each output column
+	 * @param rows the number of rows read
+	 * @return the rows, one per line
+	 */
+	static std::string formatRows(const Input & input,
+			const std::vector<uint32_t> & colPositions, uint64_t & rows);
+
+	static VecStr splitLine(const std::string & line);
+};
+
+}  // namespace njhseq
@@ -0,0 +1,223 @@
+/*
+ * MidBarcodeIndex.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "MidBarcodeIndex.hpp"
+
+namespace njhseq {
+
+const uint32_t MidBarcodeIndex::maxIndexedErrors_ = 1;
+
+MidBarcodeIndex::MidBarcodeIndex(
+		const std::unordered_map<std::string, MidDeterminator::MID> & mids,
+		const MidDeterminator::MidDeterminePars & pars) :
+		searchStart_(pars.searchStart_),
+		searchStop_(pars.searchStop_),
+		checkComplement_(pars.checkComplement_),
+		midNames_(getVectorOfMapKeys(mids)) {
+	njh::sort(midNames_);
+	if (pars.allowableErrors_ > maxIndexedErrors_ || mids.empty()) {
+		return;
+	}
+	//barcodes can be found anywhere from the start of the search to its stop, plus one more position for shortened barcodes
+	searchWindowStop_ = pars.searchStart_ + pars.searchStop_ + 1;
+	directBarcodeLengths_ = std::vector<uint32_t>(midNames_.size(), 0);
+	VecStr barcodes;
+	for (uint32_t midPos = 0; midPos < midNames_.size(); ++midPos) {
+		const auto & mid = midNames_[midPos];
+		barcodes.clear();
+		if (nullptr != mids.at(mid).forwardBar_) {
+			barcodes.emplace_back(njh::strToUpperRet(mids.at(mid).forwardBar_->bar_->motifOriginal_));
+		}
+		if (nullptr != mids.at(mid).reverseBar_) {
+			barcodes.emplace_back(njh::strToUpperRet(mids.at(mid).reverseBar_->bar_->motifOriginal_));
+		}
+		//dual barcoded MIDs need both ends checked so they always go through the determinator
+		bool directMid = nullptr != mids.at(mid).forwardBar_ && nullptr == mids.at(mid).reverseBar_;
+		for (const auto & barcode : barcodes) {
+			if (barcode.size() < 2 || std::string::npos != barcode.find_first_not_of("ACGT")) {
+				//degenerate or tiny barcodes can't be hashed, leave it to the full search
+				index_.clear();
+				barcodeLengths_.clear();
+				return;
+			}
+			if(directMid){
+				directBarcodeLengths_[midPos] = barcode.size();
+			}
+			//add both orientations so the start of a sequence and the start of its reverse complement cover both ends
+			bool forwardOrientation = true;
+			for (const auto & bar : VecStr { barcode, seqUtil::reverseComplement(barcode, "DNA") }) {
+				addBarcode(bar, midPos, pars.allowableErrors_, directMid && forwardOrientation);
+				if (pars.checkForShorten_) {
+					addBarcode(bar.substr(1), midPos, pars.allowableErrors_, false);
+					addBarcode(bar.substr(0, bar.size() - 1), midPos, pars.allowableErrors_, false);
+				}
+				forwardOrientation = false;
+			}
+		}
+	}
+	usable_ = true;
+}
+
+void MidBarcodeIndex::addBarcode(const std::string & barcode, uint32_t midPos,
+		uint32_t allowableErrors, bool direct) {
+	barcodeLengths_.emplace(barcode.size());
+	auto addVariant = [this, &midPos, &direct](const std::string & variant) {
+		auto & mids = index_[variant];
+		for (auto & indexed : mids) {
+			if (indexed.midPos_ == midPos) {
+				//reachable as both the forward barcode and something else is ambiguous, so it can't be a direct hit
+				indexed.direct_ = indexed.direct_ && direct;
+				return;
+			}
+		}
+		mids.emplace_back(IndexedBarcode { midPos, direct });
+	};
+	addVariant(barcode);
+	if (allowableErrors > 0) {
+		std::string variant = barcode;
+		for (uint32_t pos = 0; pos < barcode.size(); ++pos) {
+			for (const auto base : { 'A', 'C', 'G', 'T', 'N' }) {
+				if (base != barcode[pos]) {
+					variant[pos] = base;
+					addVariant(variant);
+				}
+			}
+			variant[pos] = barcode[pos];
+		}
+	}
+}
+
+std::string MidBarcodeIndex::getSearchWindow(const std::string & seqWindow) const {
+	//normalize the window so lower case and any odd characters count as a mismatch just like an N
+	std::string window = njh::strToUpperRet(seqWindow);
+	for (auto & base : window) {
+		if ('A' != base && 'C' != base && 'G' != base && 'T' != base) {
+			base = 'N';
+		}
+	}
+	return window;
+}
+
+void MidBarcodeIndex::addWindowCandidates(const std::string & seqWindow,
+		std::set<uint32_t> & candidatePositions) const {
+	auto window = getSearchWindow(seqWindow);
+	for (uint32_t start = 0; start <= searchWindowStop_; ++start) {
+		for (const auto barLen : barcodeLengths_) {
+			if (start + barLen > window.size()) {
+				break;
+			}
+			auto search = index_.find(window.substr(start, barLen));
+			if (index_.end() != search) {
+				for (const auto & indexed : search->second) {
+					candidatePositions.emplace(indexed.midPos_);
+				}
+			}
+		}
+	}
+}
+
+bool MidBarcodeIndex::getDirectHit(const std::string & seq,
+		DirectHit & hit) const {
+	if (!usable_) {
+		return false;
+	}
+	uint32_t windowLen = searchWindowStop_ + *barcodeLengths_.rbegin();
+	std::array<std::string, 2> windows { getSearchWindow(seq.substr(0, windowLen)),
+		getSearchWindow(seqUtil::reverseComplement(
+				seq.size() > windowLen ? seq.substr(seq.size() - windowLen) : seq, "DNA")) };
+	uint32_t hits = 0;
+	uint32_t hitMidPos = std::numeric_limits<uint32_t>::max();
+	for (uint32_t windowPos = 0; windowPos < windows.size(); ++windowPos) {
+		const auto & window = windows[windowPos];
+		for (uint32_t start = 0; start <= searchWindowStop_; ++start) {
+			for (const auto barLen : barcodeLengths_) {
+				if (start + barLen > window.size()) {
+					break;
+				}
+				auto search = index_.find(window.substr(start, barLen));
+				if (index_.end() == search) {
+					continue;
+				}
+				for (const auto & indexed : search->second) {
+					//any other MID, or any other way of matching the full barcode, is ambiguous and needs the determinator to sort out,
+					//the shortened forms of the hit barcode overlap it so they're skipped
+					if (0 == directBarcodeLengths_[indexed.midPos_]
+							|| (std::numeric_limits<uint32_t>::max() != hitMidPos && hitMidPos != indexed.midPos_)) {
+						return false;
+					}
+					hitMidPos = indexed.midPos_;
+					if (barLen != directBarcodeLengths_[indexed.midPos_]) {
+						continue;
+					}
+					if (!indexed.direct_) {
+						return false;
+					}
+					++hits;
+					if (hits > 1) {
+						return false;
+					}
+					hit.midName_ = midNames_[indexed.midPos_];
+					hit.trimTo_ = start + barLen;
+					hit.rComp_ = 1 == windowPos;
+					if (start < searchStart_ || start > searchStart_ + searchStop_) {
+						return false;
+					}
+				}
+			}
+		}
+	}
+	return 1 == hits && (!hit.rComp_ || checkComplement_);
+}
+
+std::set<std::string> MidBarcodeIndex::getCandidates(
+		const std::string & seq) const {
+	std::set<std::string> ret;
+	if (!usable_) {
+		ret.insert(midNames_.begin(), midNames_.end());
+		return ret;
+	}
+	uint32_t windowLen = searchWindowStop_ + *barcodeLengths_.rbegin();
+	std::set<uint32_t> candidatePositions;
+	addWindowCandidates(seq.substr(0, windowLen), candidatePositions);
+	addWindowCandidates(seqUtil::reverseComplement(
+					seq.size() > windowLen ? seq.substr(seq.size() - windowLen) : seq, "DNA"),
+			candidatePositions);
+	for (const auto pos : candidatePositions) {
+		ret.emplace(midNames_[pos]);
+	}
+	return ret;
+}
+
+std::set<std::string> MidBarcodeIndex::getCandidates(
+		const PairedRead & seq) const {
+	auto ret = getCandidates(seq.seqBase_.seq_);
+	if (usable_) {
+		auto mateCandidates = getCandidates(seq.mateSeqBase_.seq_);
+		ret.insert(mateCandidates.begin(), mateCandidates.end());
+	}
+	return ret;
+}
+
+}  // namespace njhseq
@@ -0,0 +1,111 @@
+#pragma once
+/*
+ * MidBarcodeIndex.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include <njhseq/common.h>
+#include <njhseq/IO/SeqIO.h>
+#include <njhseq/seqToolsUtils/determinators/MidDeterminator.hpp>
+
+namespace njhseq {
+
+/**@brief A hash of every barcode (both orientations, and shortened if checking for shorten barcodes) and all of its
+ * single mismatch neighbors to the MIDs they came from
+ *
+ * Looking up the windows at the start and end of a read gives every MID that could possibly be found by
+ * MidDeterminator when it's allowing at most maxIndexedErrors_ mismatches, so when there are candidates the determinator only needs
+ * to be run against those MIDs. The index doesn't cover indels so reads without candidates still need the full search
+ *
+ */
+class MidBarcodeIndex {
+public:
+
+	MidBarcodeIndex(const std::unordered_map<std::string, MidDeterminator::MID> & mids,
+			const MidDeterminator::MidDeterminePars & pars);
+
+	static const uint32_t maxIndexedErrors_;
+
+	bool usable_{false}; /**< whether the index can be used with the given barcodes and search parameters*/
+
+	/**@brief get the MIDs that could be found in this sequence
+	 *
+	 * @param seq the sequence to search
+	 * @return the names of all the MIDs with a barcode within the allowed errors in the search windows of seq, empty if none,
+	 * all MIDs if the index isn't usable
+	 */
+	std::set<std::string> getCandidates(const std::string & seq) const;
+
+	/**@brief get the MIDs that could be found in either mate of this pair
+	 *
+	 * @param seq the paired read to search
+	 * @return the names of all the MIDs with a barcode within the allowed errors in the search windows of either mate
+	 */
+	std::set<std::string> getCandidates(const PairedRead & seq) const;
+
+	/**@brief a barcode found by the index alone
+	 *
+	 */
+	struct DirectHit {
+		std::string midName_;
+		uint32_t trimTo_{0}; /**< the position just past the barcode, in the orientation the read ends up in*/
+		bool rComp_{false}; /**< whether the barcode was found at the end of the read, so the read is in the reverse orientation*/
+	};
+
+	/**@brief look for a single unambiguous full length forward barcode hit
+	 *
+	 * Only single barcode MIDs are hit directly, and only when exactly one MID and one position match in one orientation,
+	 * anything else (shortened barcodes, dual barcodes, several possible positions) is left to the MidDeterminator
+	 *
+	 * @param seq the sequence to search
+	 * @param hit filled in with the hit if there is one
+	 * @return whether there was a direct hit
+	 */
+	bool getDirectHit(const std::string & seq, DirectHit & hit) const;
+
+private:
+	uint32_t searchWindowStop_{0};
+	uint32_t searchStart_{0};
+	uint32_t searchStop_{0};
+	bool checkComplement_{false};
+	std::set<uint32_t> barcodeLengths_;
+	std::vector<std::string> midNames_;
+	std::vector<uint32_t> directBarcodeLengths_; /**< the length of each MID's forward barcode, 0 if it can't be hit directly*/
+
+	struct IndexedBarcode {
+		uint32_t midPos_;
+		bool direct_; /**< whether this is the full length forward barcode, or one of its mismatch neighbors, in the forward orientation*/
+	};
+	std::unordered_map<std::string, std::vector<IndexedBarcode>> index_;
+
+	void addBarcode(const std::string & barcode, uint32_t midPos,
+			uint32_t allowableErrors, bool direct);
+
+	void addWindowCandidates(const std::string & seqWindow,
+			std::set<uint32_t> & candidatePositions) const;
+
+	std::string getSearchWindow(const std::string & seqWindow) const;
+
+};
+
+}  // namespace njhseq
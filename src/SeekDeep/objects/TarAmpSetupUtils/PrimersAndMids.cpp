@@ -408,7 +408,90 @@ void PrimersAndMids::initMidDeterminator(const MidDeterminator::MidDeterminePars
 		ss << __PRETTY_FUNCTION__ << ", error mids_ are empty, can't init mid determinator" << "\n";
 		throw std::runtime_error{ss.str()};
 	}
-	mDeterminator_ = std::make_unique<MidDeterminator>(idFile_,midSearchPars);
+	mDeterminator_ = std::make_shared<MidDeterminator>(idFile_,midSearchPars);
+	midSearchPars_ = midSearchPars;
+	midIndex_ = std::make_shared<MidBarcodeIndex>(mDeterminator_->mids_, midSearchPars);
+	//a new cache rather than clearing, any copies made before this keep the one that matches their determinator
+	restrictedMidDeterminators_ = std::make_shared<RestrictedMidDeterminators>();
+}
+
+MidDeterminator & PrimersAndMids::getMidDeterminatorFor(const std::set<std::string> & candidates){
+	//only single mid determinators are cached, so there's at most one per mid, reads with several candidates use the full search
+	if(1 != candidates.size() || mDeterminator_->mids_.size() < 2){
+		return *mDeterminator_;
+	}
+	const auto & mid = *candidates.begin();
+	std::lock_guard<std::mutex> lock(restrictedMidDeterminators_->mut_);
+	auto search = restrictedMidDeterminators_->determinators_.find(mid);
+	if(restrictedMidDeterminators_->determinators_.end() != search){
+		return *search->second;
+	}
+	auto restricted = std::make_unique<MidDeterminator>(idFile_, midSearchPars_);
+	for(const auto & otherMid : getVectorOfMapKeys(restricted->mids_)){
+		if(otherMid != mid){
+			restricted->mids_.erase(otherMid);
+		}
+	}
+	auto & ret = *restricted;
+	restrictedMidDeterminators_->determinators_.emplace(mid, std::move(restricted));
+	return ret;
+}
+
+MidDeterminator::ProcessedRes PrimersAndMids::searchAndProcessMid(seqInfo & seq){
+	if(nullptr != midIndex_ && midIndex_->usable_){
+		MidBarcodeIndex::DirectHit hit;
+		if(midIndex_->getDirectHit(seq.seq_, hit)){
+			//a single full length barcode within the allowed errors, orient and trim it off the same as MidDeterminator::processSearchRead
+			if(hit.rComp_){
+				seq.reverseComplementRead(false, true);
+			}
+			readVecTrimmer::trimOffForwardBases(seq, hit.trimTo_);
+			MidDeterminator::ProcessedRes ret;
+			ret.case_ = MidDeterminator::ProcessedRes::PROCESSED_CASE::MATCH;
+			ret.midName_ = hit.midName_;
+			ret.rcomplement_ = hit.rComp_;
+			return ret;
+		}
+		auto candidates = midIndex_->getCandidates(seq.seq_);
+		if(!candidates.empty()){
+			auto & determinator = getMidDeterminatorFor(candidates);
+			if(&determinator != mDeterminator_.get()){
+				//search a copy so a miss against the restricted mids leaves the read untouched for the full search
+				seqInfo restrictedSeq = seq;
+				auto searchRes = determinator.searchRead(restrictedSeq);
+				auto processRes = determinator.processSearchRead(restrictedSeq, searchRes);
+				if(MidDeterminator::ProcessedRes::PROCESSED_CASE::MATCH == processRes.case_){
+					seq = std::move(restrictedSeq);
+					return processRes;
+				}
+			}
+		}
+	}
+	//no candidates can still mean a barcode with an indel, and the restricted search can miss when another mid's barcode is a spurious
+	//mismatch hit, so both fall back to the full search which will find it with the aligner
+	auto searchRes = mDeterminator_->searchRead(seq);
+	return mDeterminator_->processSearchRead(seq, searchRes);
+}
+
+MidDeterminator::ProcessedRes PrimersAndMids::searchAndProcessMid(PairedRead & seq){
+	//the mates are oriented and trimmed together by processSearchPairedEndRead, so pairs only use the index to restrict the search
+	if(nullptr != midIndex_ && midIndex_->usable_){
+		auto candidates = midIndex_->getCandidates(seq);
+		if(!candidates.empty()){
+			auto & determinator = getMidDeterminatorFor(candidates);
+			if(&determinator != mDeterminator_.get()){
+				PairedRead restrictedSeq = seq;
+				auto searchRes = determinator.searchPairedEndRead(restrictedSeq);
+				auto processRes = determinator.processSearchPairedEndRead(restrictedSeq, searchRes);
+				if(MidDeterminator::ProcessedRes::PROCESSED_CASE::MATCH == processRes.case_){
+					seq = std::move(restrictedSeq);
+					return processRes;
+				}
+			}
+		}
+	}
+	auto searchRes = mDeterminator_->searchPairedEndRead(seq);
+	return mDeterminator_->processSearchPairedEndRead(seq, searchRes);
 }
 
 void PrimersAndMids::initPrimerDeterminator(){
@@ -421,7 +504,7 @@ void PrimersAndMids::initPrimerDeterminator(){
 	for(const auto & tar : targets_){
 		pInfos.emplace(tar.second.info_.primerPairName_, tar.second.info_);
 	}
-	pDeterminator_ = std::make_unique<PrimerDeterminator>(pInfos);
+	pDeterminator_ = std::make_shared<PrimerDeterminator>(pInfos);
 }
 
 void PrimersAndMids::addLenCutOffs(const bfs::path & lenCutOffsFnp){
@@ -30,8 +30,11 @@
 #include <njhseq/seqToolsUtils/determinators/MidDeterminator.hpp>
 #include <njhseq/seqToolsUtils/determinators/PrimerDeterminator.hpp>
 #include <njhseq/readVectorManipulation/readVectorHelpers/readChecker.hpp>
+#include <njhseq/readVectorManipulation/readVectorHelpers/readVecTrimmer.hpp>
 
 #include "SeekDeep/objects/IlluminaUtils/PairedReadProcessor.hpp"
+#include "SeekDeep/objects/KmerUtils/PackedKmerSet.hpp"
+#include "SeekDeep/objects/TarAmpSetupUtils/MidBarcodeIndex.hpp"
 
 namespace njhseq {
 
@@ -69,7 +72,7 @@ public:
 
 		PrimerDeterminator::primerInfo info_;
 		std::vector<seqInfo> refs_;
-		std::vector<kmerInfo> refKInfos_;
+		std::vector<PackedKmerSet> refKInfos_;
 
 		std::shared_ptr<lenCutOffs> lenCuts_;
 
@@ -95,12 +98,48 @@ public:
 	std::unordered_map<std::string, Target> targets_;
 	std::unordered_map<std::string, MidDeterminator::MID> mids_;
 
-	std::unique_ptr<MidDeterminator> mDeterminator_;
-	std::unique_ptr<PrimerDeterminator> pDeterminator_;
+	/**@brief determinators with only a single mid, keyed by that mid
+	 *
+	 */
+	struct RestrictedMidDeterminators {
+		std::mutex mut_;
+		std::unordered_map<std::string, std::unique_ptr<MidDeterminator>> determinators_;
+	};
+
+	//copies share the determinators and the mid index (e.g. extractorBatch copies a fully initialized PrimersAndMids for each extraction a
+	//worker thread runs), so copies shouldn't be searched with from several threads at once, the targets (length cut offs, overlap statuses,
+	//refs) belong to each copy
+	std::shared_ptr<MidDeterminator> mDeterminator_;
+	std::shared_ptr<PrimerDeterminator> pDeterminator_;
+
+	std::shared_ptr<MidBarcodeIndex> midIndex_;
+	MidDeterminator::MidDeterminePars midSearchPars_;
+	std::shared_ptr<RestrictedMidDeterminators> restrictedMidDeterminators_ = std::make_shared<RestrictedMidDeterminators>();
 
 	void initAllAddLenCutsRefs(const InitPars & pars);
 
 	void initMidDeterminator(const MidDeterminator::MidDeterminePars & midSearchPars);
+
+	/**@brief search for and process the MID in seq, a single full length barcode hit in the index is used directly, otherwise the
+	 * barcode index is used to only search the MIDs that could match and the full search is the fallback
+	 *
+	 * @param seq the read to search, will be modified the same as MidDeterminator::processSearchRead
+	 * @return the processed results
+	 */
+	MidDeterminator::ProcessedRes searchAndProcessMid(seqInfo & seq);
+	/**@brief search for and process the MID in seq, the barcode index is used to only search the MIDs that could match
+	 *
+	 * @param seq the paired read to search, will be modified the same as MidDeterminator::processSearchPairedEndRead
+	 * @return the processed results
+	 */
+	MidDeterminator::ProcessedRes searchAndProcessMid(PairedRead & seq);
+
+	/**@brief get a determinator to search for the candidate mids with, a cached single mid determinator when there's only one candidate otherwise the full determinator
+	 *
+	 * @param candidates the mids from the barcode index
+	 * @return the determinator to search with
+	 */
+	MidDeterminator & getMidDeterminatorFor(const std::set<std::string> & candidates);
 	void initPrimerDeterminator();
 
 	bool hasTarget(const std::string & target) const;
@@ -106,6 +106,15 @@ void CoreExtractorPars::setCorePars(seqSetUp & setUp){
 	setUp.setOption(keepUnfilteredReads, "--keepUnfilteredReads", "Keep the unfiltered reads for debugging purposes", false);
 	setUp.setOption(keepFilteredOff, "--keepFilteredOff", "Keep Filtered Off", false);
 
+	setUp.setOption(outPoolPars_.maxOpen_, "--maxOpenOutputs",
+			"The maximum number of output files to keep open at once while splitting by barcodes and primers, least recently used files are closed and re-opened as needed, gzipped outputs are always kept open", false, "Output");
+	setUp.setOption(outPoolPars_.bufferSize_, "--outputBufferSize",
+			"The number of sequences to hold in memory per output file before writing them out in one block", false, "Output");
+	if(0 == outPoolPars_.maxOpen_){
+		setUp.failed_ = true;
+		setUp.addWarning("Error --maxOpenOutputs should be greater than 0");
+	}
+
 }
 
 
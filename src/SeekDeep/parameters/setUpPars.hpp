@@ -39,6 +39,7 @@
 #include "SeekDeep/objects/IlluminaUtils/PairedReadProcessor.hpp"
 #include "SeekDeep/objects/TarAmpSetupUtils/PrimersAndMids.hpp"
 #include "SeekDeep/objects/IlluminaUtils/IlluminaNameFormatDecoder.hpp"
+#include "SeekDeep/objects/SeqIOUtils/MultiSeqOutPool.hpp"
 #include <njhseq/PopulationGeneticsUtils.h>
 
 namespace njhseq {
@@ -66,6 +67,8 @@ struct CoreExtractorPars{
 
   bool keepUnfilteredReads = false;
   bool keepFilteredOff = false;
+
+  MultiSeqOutPool::PoolPars outPoolPars_;
   void setCorePars(seqSetUp & setUp);
 
 };
@@ -184,6 +187,9 @@ struct clusterDownPars {
 	uint32_t BackUpIlluminaSampleNumberPos_ = 12;
 
 	SnapShotsOpts snapShotsOpts_;
+
+	uint32_t numThreads = 1;
+	bfs::path sharedAlnCacheDir = ""; //a directory of alignments that can be shared with other runs
 };
 
 struct processClustersPars {
@@ -192,9 +198,13 @@ struct processClustersPars {
   //bool noPopulation = false;
   std::string previousPopFilename = "";
   comparison previousPopErrors;
+  uint32_t previousPopKLength = 0; //kmer length for finding previous population sequences near a haplotype, 0 to pick one from the allowed edits
 
   uint32_t numThreads = 1;
   bool writeOutAllInfoFile = false;
+  bfs::path sharedAlnCacheDir = ""; //a directory of alignments that can be shared with other runs
+  bfs::path sampleCacheDir = ""; //a directory of per sample results so only new or changed samples are redone
+  double maxMemory = 0; //GB of sample results to hold in memory before writing them out, 0 for no limit
 
   std::string parameters = "";
   std::string binParameters = "";
@@ -278,6 +288,21 @@ struct makeSampleDirectoriesPars{
 	bool separatedDirs = false;
 };
 
+struct ExtractorBatchPars{
+	bfs::path batchTableFnp;
+	bfs::path idFile;
+	bool pairedEnd = false;
+	std::string extractorArgs;
+	uint32_t numThreads = 1;
+};
+
+struct QlusterBatchPars{
+	bfs::path batchTableFnp;
+	bfs::path parFnp;
+	std::string qlusterArgs;
+	uint32_t numThreads = 1;
+};
+
 
 }  // namespace njhseq
 
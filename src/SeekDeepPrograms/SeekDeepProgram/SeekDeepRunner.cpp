@@ -39,9 +39,11 @@ SeekDeepRunner::SeekDeepRunner() :
 				{
 						addFunc("extractor", extractor, false),
 						addFunc("extractorPairedEnd", extractorPairedEnd, false),
+						addFunc("extractorBatch", extractorBatch, false),
 						addFunc("processClusters", processClusters,false),
 						addFunc("qluster", clusterDown, false),
 						addFunc("clusterDown",clusterDown, true),
+						addFunc("qlusterBatch", qlusterBatch, false),
 						addFunc("makeSampleDirectories", makeSampleDirectories, false)
 				}, "SeekDeep", "3", "0", "1") {
 }
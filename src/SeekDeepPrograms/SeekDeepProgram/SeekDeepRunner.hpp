@@ -39,7 +39,23 @@ class SeekDeepRunner : public njh::progutils::OneRing {
   SeekDeepRunner();
   static int extractor(const njh::progutils::CmdArgs & inputCommands);
   static int extractorPairedEnd(const njh::progutils::CmdArgs & inputCommands);
+  static int extractorBatch(const njh::progutils::CmdArgs & inputCommands);
+  //extraction split into reading in the primers and MIDs and the extraction itself so extractorBatch can build the ids once and share them
+  static PrimersAndMids genExtractorIds(const extractorPars & pars, bool verbose);
+  static int runExtractor(SeekDeepSetUp & setUp, extractorPars & pars, PrimersAndMids & ids);
+  static PrimersAndMids genExtractorPairedEndIds(const ExtractorPairedEndPars & pars, bool verbose);
+  static int runExtractorPairedEnd(SeekDeepSetUp & setUp, ExtractorPairedEndPars & pars, PrimersAndMids & ids);
   static int clusterDown(const njh::progutils::CmdArgs & inputCommands);
+  //the aligner and collapser a clustering builds, qlusterBatch hands them on to later inputs clustered with the same arguments
+  struct ClusterDownTools {
+    ClusterDownTools(const SeekDeepSetUp & setUp, uint64_t maxSize, const KmerMaps & kMaps);
+    aligner alignerObj_;
+    collapser collapserObj_;
+  };
+  //clustering split into its set up and the clustering itself, toolsPool can be nullptr, otherwise the tools are taken from and given back to it under toolsKey
+  static int runClusterDown(SeekDeepSetUp & setUp, clusterDownPars & pars,
+      ReusePool<ClusterDownTools> * toolsPool, const std::string & toolsKey);
+  static int qlusterBatch(const njh::progutils::CmdArgs & inputCommands);
   //.cpp
   static int processClusters(const njh::progutils::CmdArgs & inputCommands);
   static int makeSampleDirectories(const njh::progutils::CmdArgs & inputCommands);
@@ -23,6 +23,54 @@
 #include <njhcpp/bashUtils.h>
 namespace njhseq {
 
+CollapseIterations SeekDeepSetUp::processIteratorMapShared(
+		const std::string & parFnp, bool onPerId) {
+	//shared by every set up in the process so batch runs only parse each parameters file once
+	static std::mutex cacheMut;
+	static std::unordered_map<std::string, CollapseIterations> cache;
+	std::string key = njh::pasteAsStr(onPerId ? "perId:" : "errors:", parFnp);
+	{
+		std::lock_guard<std::mutex> lock(cacheMut);
+		auto search = cache.find(key);
+		if (cache.end() != search) {
+			return search->second;
+		}
+	}
+	auto ret = onPerId ? processIteratorMapOnPerId(parFnp) : processIteratorMap(parFnp);
+	if (!failed_) {
+		std::lock_guard<std::mutex> lock(cacheMut);
+		cache.emplace(key, ret);
+	}
+	return ret;
+}
+
+void SeekDeepSetUp::throwIfHelpInsteadOfExit() {
+	if (throwInsteadOfExit_ && needsHelp()) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error help was requested for " << commands_.subProgram_ << ", can't print help from within a batch run" << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+}
+
+void SeekDeepSetUp::finishSetUp(std::ostream & out) {
+	if (throwInsteadOfExit_) {
+		throwIfHelpInsteadOfExit();
+		//checked here since the base set up exits on any of these
+		lookForInvalidOptions();
+		if (failed_) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error in setting up " << commands_.subProgram_ << "\n";
+			printWarnings(ss);
+			throw std::runtime_error { ss.str() };
+		}
+	}
+	if (quiet_) {
+		pars_.verbose_ = false;
+		pars_.debug_ = false;
+	}
+	seqSetUp::finishSetUp(out);
+}
+
 
 
 
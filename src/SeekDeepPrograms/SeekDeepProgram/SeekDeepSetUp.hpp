@@ -39,9 +39,42 @@ class SeekDeepSetUp : public seqSetUp {
 
 	void setUpExtractorPairedEnd(ExtractorPairedEndPars & pars);
 	void setUpExtractor(extractorPars & pars);
+	void setUpExtractorBatch(ExtractorBatchPars & pars);
 	void setUpClusterDown(clusterDownPars & pars);
 	void setUpMultipleSampleCluster(processClustersPars & pars);
 	void setUpMakeSampleDirectories(makeSampleDirectoriesPars & pars);
+	void setUpQlusterBatch(QlusterBatchPars & pars);
+
+	/**@brief parse a clustering parameters file, each file is only parsed once per process and later calls get a copy
+	 *
+	 * @param parFnp the parameters file
+	 * @param onPerId whether the file has percent identities rather than errors
+	 * @return the iterations
+	 */
+	CollapseIterations processIteratorMapShared(const std::string & parFnp, bool onPerId);
+
+	/**@brief when true a failed set up or a help request throws rather than exiting, set by the batch programs which run many set ups in one process
+	 *
+	 */
+	bool throwInsteadOfExit_{false};
+
+	/**@brief when true verbose and debug output are turned off once set up is done, set by the batch programs when rows run on several
+	 * threads at once so their messages and progress bars don't interleave on std::cout, each row's run log is still written
+	 *
+	 */
+	bool quiet_{false};
+
+	/**@brief throw if help was requested and throwInsteadOfExit_ is set, called at the start of the help blocks that print extra info and then exit
+	 *
+	 */
+	void throwIfHelpInsteadOfExit();
+
+	/**@brief same as seqSetUp::finishSetUp but throws on help or a failed set up when throwInsteadOfExit_ is set and turns off verbose
+	 * and debug output when quiet_ is set
+	 *
+	 * @param out the stream to print set up info to
+	 */
+	void finishSetUp(std::ostream & out);
 
 };
 }  // namespace njhseq
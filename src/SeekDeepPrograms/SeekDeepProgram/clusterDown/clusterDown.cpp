@@ -34,12 +34,29 @@ namespace njhseq {
 
 
 
+SeekDeepRunner::ClusterDownTools::ClusterDownTools(const SeekDeepSetUp & setUp,
+		uint64_t maxSize, const KmerMaps & kMaps) :
+		alignerObj_(maxSize,
+				setUp.pars_.gapInfo_,
+				setUp.pars_.scoring_,
+				kMaps,
+				setUp.pars_.qScorePars_,
+				setUp.pars_.colOpts_.alignOpts_.countEndGaps_,
+				setUp.pars_.colOpts_.iTOpts_.weighHomopolyer_),
+		collapserObj_(setUp.pars_.colOpts_) {
+}
+
 int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 	SeekDeepSetUp setUp(inputCommands);
 	// parameters
 	clusterDownPars pars;
 
 	setUp.setUpClusterDown(pars);
+	return runClusterDown(setUp, pars, nullptr, "");
+}
+
+int SeekDeepRunner::runClusterDown(SeekDeepSetUp & setUp, clusterDownPars & pars,
+		ReusePool<ClusterDownTools> * toolsPool, const std::string & toolsKey) {
 	// make the runLog, this is what is seen on the terminal screen at run time
 	setUp.startARunLog(setUp.pars_.directoryName_);
 	// parameter file
@@ -80,6 +97,19 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 	//
 	std::unordered_map<std::string, uint32_t> sampleNumberCounts;
 	std::vector<std::shared_ptr<IlluminaNameFormatDecoder>> decodedNames;
+	//compile the name patterns once rather than for every read
+	const std::regex illuminaSampleRegPat(pars.IlluminaSampleRegPatStr_);
+	const std::regex backUpIlluminaSampleRegPat(pars.BackUpIlluminaSampleRegPatStr_);
+	auto decodeIlluminaName = [&pars,&illuminaSampleRegPat,&backUpIlluminaSampleRegPat](std::string name){
+		if(njh::endsWith(name, "_Comp")){
+			name = name.substr(0, name.rfind("_Comp"));
+		}
+		std::shared_ptr<IlluminaNameFormatDecoder> decoder=std::make_shared<IlluminaNameFormatDecoder>(name, illuminaSampleRegPat, pars.IlluminaSampleNumberPos_);
+		if(0 == decoder->match_.size()){
+			decoder =std::make_shared<IlluminaNameFormatDecoder>(name, backUpIlluminaSampleRegPat, pars.BackUpIlluminaSampleNumberPos_);
+		}
+		return decoder;
+	};
 	if(!pars.dontFilterToMostCommonIlluminaSampleNumber_){
 		setUp.rLog_.logCurrentTime("Filtering for illumina input name");
 		uint32_t totalInputCount = 0;
@@ -88,14 +118,7 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 			counterIo.openIn();
 			seqInfo seq;
 			while(counterIo.readNextRead(seq)){
-				std::string name = seq.name_;
-				if(njh::endsWith(name, "_Comp")){
-					name = name.substr(0, name.rfind("_Comp"));
-				}
-				std::shared_ptr<IlluminaNameFormatDecoder> decoder=std::make_shared<IlluminaNameFormatDecoder>(name, pars.IlluminaSampleRegPatStr_, pars.IlluminaSampleNumberPos_);
-				if(0 == decoder->match_.size()){
-					decoder =std::make_shared<IlluminaNameFormatDecoder>(name, pars.BackUpIlluminaSampleRegPatStr_, pars.BackUpIlluminaSampleNumberPos_);
-				}
+				auto decoder = decodeIlluminaName(seq.name_);
 				decodedNames.emplace_back(decoder);
 				++sampleNumberCounts[decoder->getSampleNumber()];
 				++totalInputCount;
@@ -208,8 +231,13 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 	reader.openIn();
 	std::vector<cluster> clusters;
 	uint32_t counter = 0;
-	std::unordered_map<uint32_t, std::vector<uint64_t>> filepositions;
+	//collapses reads to unique sequences while reading in and keeps where their reads are in the input, the id of each is its position in uniqueReads and then clusters
+	ReadDedupIndex readDedup;
+	//one copy of each unique read while reading in, only turned into a cluster (which keeps a second copy as its first read) once its qualities are set
+	std::vector<seqInfo> uniqueReads;
 	std::unordered_map<std::string, uint32_t> clusterNameToFilePosKey;
+	//illumina sample number counts for each unique sequence, indexed by its id in readDedup, filled during read in so the final report doesn't need to re-read the input
+	std::vector<std::unordered_map<std::string, uint32_t>> uniqueSampleNumberCounts;
 
 	aligner alignerForTrimming ;
 	if(pars.trimmingToSeq){
@@ -240,6 +268,8 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 				}
 			}
 
+			//keep the name as it was in the input for decoding the sample number
+			const std::string originalName = pars.countIlluminaSampleNumbers_ ? seq.name_ : std::string("");
 			if(njh::in(seq.name_, allNameCounts)){
 				++allNameCounts[seq.name_];
 				seq.name_.append(njh::pasteAsStr(".", allNameCounts[seq.name_]));
@@ -269,31 +299,39 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 			if(len(seq) <= pars.smallReadSize){
 				smallWriter.openWrite(seq);
 			}else{
-			  bool found = false;
-			  for(const auto clusPos : iter::range(clusters.size())){
-			  	if(seq.seq_ == clusters[clusPos].seqBase_.seq_){
-			  		clusters[clusPos].seqBase_.cnt_ += seq.cnt_;
-			  		clusters[clusPos].firstReadCount_ += seq.cnt_;
-			  		found = true;
-			  		filepositions[clusPos].emplace_back(fPos);
-			  		break;
-			  	}
+			  auto clusPos = readDedup.add(seq.seq_, fPos,
+			  		[&uniqueReads](uint32_t id) -> const std::string & {return uniqueReads[id].seq_;});
+			  if(clusPos < uniqueReads.size()){
+			  	uniqueReads[clusPos].cnt_ += seq.cnt_;
+			  }else{
+			  	uniqueReads.emplace_back(seq);
 			  }
-			  if(!found){
-		  		filepositions[clusters.size()].emplace_back(fPos);
-			  	clusters.emplace_back(seq);
+			  if(pars.countIlluminaSampleNumbers_){
+			  	if(clusPos >= uniqueSampleNumberCounts.size()){
+			  		uniqueSampleNumberCounts.resize(clusPos + 1);
+			  	}
+			  	//the decoded names line up with the read index only when the original input is being read
+			  	if(!downsampled && !pars.dontFilterToMostCommonIlluminaSampleNumber_){
+			  		++uniqueSampleNumberCounts[clusPos][decodedNames[seqIndex - 1]->getSampleNumber()];
+			  	}else{
+			  		++uniqueSampleNumberCounts[clusPos][decodeIlluminaName(originalName)->getSampleNumber()];
+			  	}
 			  }
 			}
 			fPos = reader.tellgPri();
 		}
 		reader.reOpenIn();
+		readDedup.finalize();
 		setUp.rLog_.logCurrentTime("calculating the quality values");
 
 		//now calculate the qualities if fastq
-		for(const auto & fPositions : filepositions){
+		clusters.reserve(uniqueReads.size());
+		for(const auto clusPos : iter::range(readDedup.size())){
+			const auto fPositions = std::make_pair(clusPos, readDedup.getPositions(clusPos));
+			auto & uniqueRead = uniqueReads[clusPos];
 			if(setUp.pars_.ioOptions_.inFormat_ != SeqIOOptions::inFormats::FASTA && setUp.pars_.ioOptions_.inFormat_ != SeqIOOptions::inFormats::FASTAGZ){
 				//first iterator over the files positions for the seq and read in their qualities
-				std::vector<std::vector<uint32_t>> qualities(clusters[fPositions.first].seqBase_.qual_.size());
+				std::vector<std::vector<uint32_t>> qualities(uniqueRead.qual_.size());
 				for(const auto seqPos : fPositions.second){
 					reader.seekgPri(seqPos);
 					reader.readNextRead(seq);
@@ -324,24 +362,24 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 
 				//calculate qualities
 		    if (pars.qualRep == "worst") {
-		    	clusters[fPositions.first].seqBase_.qual_.clear();
-				  for (const auto i : iter::range(clusters[fPositions.first].seqBase_.seq_.size())) {
-				  	clusters[fPositions.first].seqBase_.qual_.push_back(vectorMinimum(qualities[i]));
+		    	uniqueRead.qual_.clear();
+				  for (const auto i : iter::range(uniqueRead.seq_.size())) {
+				  	uniqueRead.qual_.push_back(vectorMinimum(qualities[i]));
 				  }
 		    } else if (pars.qualRep == "median") {
-		    	clusters[fPositions.first].seqBase_.qual_.clear();
-				  for (const auto i : iter::range(clusters[fPositions.first].seqBase_.seq_.size())) {
-				  	clusters[fPositions.first].seqBase_.qual_.push_back(vectorMedianRef(qualities[i]));
+		    	uniqueRead.qual_.clear();
+				  for (const auto i : iter::range(uniqueRead.seq_.size())) {
+				  	uniqueRead.qual_.push_back(vectorMedianRef(qualities[i]));
 				  }
 		    } else if (pars.qualRep == "average") {
-		    	clusters[fPositions.first].seqBase_.qual_.clear();
-				  for (const auto i : iter::range(clusters[fPositions.first].seqBase_.seq_.size())) {
-				  	clusters[fPositions.first].seqBase_.qual_.push_back(vectorMean(qualities[i]));
+		    	uniqueRead.qual_.clear();
+				  for (const auto i : iter::range(uniqueRead.seq_.size())) {
+				  	uniqueRead.qual_.push_back(vectorMean(qualities[i]));
 				  }
 		    } else if (pars.qualRep == "bestQual") {
-		    	clusters[fPositions.first].seqBase_.qual_.clear();
-				  for (const auto i : iter::range(clusters[fPositions.first].seqBase_.seq_.size())) {
-				  	clusters[fPositions.first].seqBase_.qual_.push_back(vectorMaximum(qualities[i]));
+		    	uniqueRead.qual_.clear();
+				  for (const auto i : iter::range(uniqueRead.seq_.size())) {
+				  	uniqueRead.qual_.push_back(vectorMaximum(qualities[i]));
 				  }
 		    } else {
 		    	std::stringstream ss;
@@ -351,18 +389,28 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 		      throw std::runtime_error{ss.str()};
 		    }
 			}
-			clusters[fPositions.first].averageErrorRate = clusters[fPositions.first].getAverageErrorRate();
-			clusters[fPositions.first].updateName();
-			clusters[fPositions.first].reads_.front()->averageErrorRate = clusters[fPositions.first].getAverageErrorRate();
-			clusters[fPositions.first].reads_.front()->seqBase_ = clusters[fPositions.first].seqBase_;
-			clusterNameToFilePosKey[clusters[fPositions.first].seqBase_.name_] = fPositions.first;
+			clusters.emplace_back(uniqueRead);
+			//free the unique read now that the cluster has it
+			uniqueRead = seqInfo();
+			auto & clus = clusters.back();
+			clus.firstReadCount_ = clus.seqBase_.cnt_;
+			clus.averageErrorRate = clus.getAverageErrorRate();
+			clus.updateName();
+			clus.reads_.front()->averageErrorRate = clus.getAverageErrorRate();
+			clus.reads_.front()->seqBase_ = clus.seqBase_;
+			clusterNameToFilePosKey[clus.seqBase_.name_] = fPositions.first;
 		}
+		uniqueReads = std::vector<seqInfo>{};
+		//the hash index is only needed while collapsing, the file positions are kept for writing out the initial sequences
+		readDedup.releaseIndex();
 	}
 	setUp.rLog_.logCurrentTime("Clearing data");
 	decodedNames.clear();
-	if(!pars.countIlluminaSampleNumbers_ && !pars.writeOutInitalSeqs){
-		filepositions.clear();
-		clusterNameToFilePosKey.clear();
+	if(!pars.writeOutInitalSeqs){
+		readDedup.clearPositions();
+		if(!pars.countIlluminaSampleNumbers_){
+			clusterNameToFilePosKey.clear();
+		}
 	}
 	setUp.rLog_.logCurrentTime("Post processing after collapse");
 
@@ -415,15 +463,34 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 			setUp.pars_.colOpts_.kmerOpts_.kmersByPosition_,
 			setUp.pars_.expandKmerPos_,
 			setUp.pars_.expandKmerSize_);
-	setUp.rLog_.logCurrentTime("Creating aligner");
-	// create aligner class object
-	aligner alignerObj(maxSize,
-			setUp.pars_.gapInfo_,
-			setUp.pars_.scoring_,
-			kMaps,
-			setUp.pars_.qScorePars_,
-			setUp.pars_.colOpts_.alignOpts_.countEndGaps_,
-			setUp.pars_.colOpts_.iTOpts_.weighHomopolyer_);
+	//keep the counts the kmer maps were made from so they can be updated rather than re-indexed after clustering
+	IncrementalKmerCounts::IncrementalKmerCountsPars incKmerPars;
+	incKmerPars.kLength_ = setUp.pars_.colOpts_.kmerOpts_.kLength_;
+	incKmerPars.runCutOff_ = setUp.pars_.colOpts_.kmerOpts_.runCutOff_;
+	incKmerPars.kmersByPosition_ = setUp.pars_.colOpts_.kmerOpts_.kmersByPosition_;
+	incKmerPars.expandKmerPos_ = setUp.pars_.expandKmerPos_;
+	incKmerPars.expandKmerSize_ = setUp.pars_.expandKmerSize_;
+	IncrementalKmerCounts incKmerCounts(incKmerPars);
+	if(!pars.dontRecalLowFreqMismatchAndReRun){
+		incKmerCounts.setBaseline(clusters);
+	}
+	std::unique_ptr<ClusterDownTools> tools;
+	if(nullptr != toolsPool){
+		tools = toolsPool->checkOut(toolsKey);
+	}
+	if(nullptr == tools){
+		setUp.rLog_.logCurrentTime("Creating aligner");
+		// create aligner class object
+		tools = std::make_unique<ClusterDownTools>(setUp, maxSize, kMaps);
+	}else{
+		//left over from an earlier input clustered with the same arguments, so only what depends on the input needs setting
+		setUp.rLog_.logCurrentTime("Re-using aligner");
+		tools->alignerObj_.parts_.setMaxSize(maxSize);
+		tools->alignerObj_.kMaps_ = kMaps;
+		tools->alignerObj_.numberOfAlingmentsDone_ = 0;
+		tools->collapserObj_.opts_ = setUp.pars_.colOpts_;
+	}
+	aligner & alignerObj = tools->alignerObj_;
 	if (setUp.pars_.verbose_ && !pars.onPerId) {
 		std::cout << njh::bashCT::bold << "Primary Qual: "
 				<< alignerObj.qScorePars_.primaryQual_ << std::endl;
@@ -447,6 +514,20 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 	}
 	setUp.rLog_.logCurrentTime("Reading in previous alignments");
 	alignerObj.processAlnInfoInput(setUp.pars_.alnInfoDirName_, setUp.pars_.verbose_);
+	std::unique_ptr<AlnCacheStore> sharedAlnCache;
+	if("" != pars.sharedAlnCacheDir){
+		setUp.rLog_.logCurrentTime("Reading in shared alignments");
+		sharedAlnCache = std::make_unique<AlnCacheStore>(pars.sharedAlnCacheDir, alignerObj);
+		//only the alignments between the input sequences can be used, consensus sequences made while clustering will be new
+		std::unordered_set<std::string> relevantSeqs;
+		for(const auto & clus : clusters){
+			relevantSeqs.emplace(clus.seqBase_.seq_);
+		}
+		for(const auto & ref : refSequences){
+			relevantSeqs.emplace(ref.seqBase_.seq_);
+		}
+		sharedAlnCache->load(alignerObj, relevantSeqs, setUp.pars_.verbose_);
+	}
 	if(setUp.pars_.verbose_){
 		uint32_t alignmentsReadIn = 0;
 		for(const auto & alnHold : alignerObj.alnHolder_.globalHolder_){
@@ -460,7 +541,7 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 		std::cout << "Read in: " << alignmentsReadIn << "alignments" << std::endl;
 	}
 	setUp.rLog_.logCurrentTime("Removing singlets");
-	collapser collapserObj = collapser(setUp.pars_.colOpts_);
+	collapser & collapserObj = tools->collapserObj_;
 
 	uint32_t singletonNum = 0;
 	std::vector<cluster> singletons;
@@ -482,46 +563,160 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 			std::cout << "Removed " << singletons.size() << " singlets" << std::endl;
 		}
 	}
+	//align the candidates for each round of clustering across threads ahead of time, the clustering itself stays serial
+	CollapsePreAligner::PreAlignPars preAlignPars;
+	preAlignPars.numThreads_ = pars.numThreads;
+	preAlignPars.verbose_ = setUp.pars_.verbose_;
+	preAlignPars.kmerLength_ = setUp.pars_.colOpts_.kmerOpts_.kLength_;
+	CollapsePreAligner preAligner(preAlignPars);
+	//pairs can only be ruled out by edit distance when every error the aligner finds is counted against the iteration
+	bool checkPreAlignEdits = !pars.onPerId
+			&& setUp.pars_.colOpts_.alignOpts_.countEndGaps_
+			&& !setUp.pars_.colOpts_.iTOpts_.weighHomopolyer_
+			&& !setUp.pars_.colOpts_.alignOpts_.noAlign_;
+	auto preAlignForClustering = [&preAligner,&checkPreAlignEdits,&pars,&setUp,&clusters,&alignerObj](const CollapseIterations & iterMap){
+		if(setUp.pars_.colOpts_.alignOpts_.noAlign_ || iterMap.iters_.empty()){
+			return;
+		}
+		preAligner.pars_.candidatesPerRead_ = iterMap.iters_.begin()->second.stopCheck_;
+		preAligner.pars_.maxEdits_ = checkPreAlignEdits ? CollapsePreAligner::getMaxEdits(iterMap) : std::numeric_limits<uint32_t>::max();
+		preAligner.pars_.iterationMaxEdits_ = CollapsePreAligner::getIterationMaxEdits(iterMap);
+		auto preAlignCounts = preAligner.preAlign(clusters, alignerObj,
+				njh::files::make_path(setUp.pars_.directoryName_, "preAlignCache"));
+		if(preAlignCounts.aligned_ > 0){
+			setUp.rLog_ << "Pre-aligned " << preAlignCounts.aligned_ << " candidate pairs with " << pars.numThreads << " threads" << "\n";
+		}
+		if(preAlignCounts.candidates_ > 0 && preAlignCounts.unpassableByIteration_.size() == iterMap.iters_.size()){
+			setUp.rLog_ << "Skipped aligning " << preAlignCounts.skippedByKmers_ + preAlignCounts.skippedByEdits_ << " of " << preAlignCounts.candidates_
+					<< " candidate pairs more than " << preAligner.pars_.maxEdits_ << " edits apart, "
+					<< preAlignCounts.skippedByKmers_ << " by shared kmers, " << preAlignCounts.skippedByEdits_ << " by banded edit distance" << "\n";
+			uint32_t iterPos = 0;
+			for(const auto & iter : iterMap.iters_){
+				setUp.rLog_ << "\tIteration " << iter.first << ": "
+						<< preAlignCounts.unpassableByIteration_[iterPos] << " of " << preAlignCounts.candidates_
+						<< " (" << 100.0 * preAlignCounts.unpassableByIteration_[iterPos] / preAlignCounts.candidates_ << "%)"
+						<< " can't pass with at most " << preAligner.pars_.iterationMaxEdits_[iterPos] << " edits" << "\n";
+				++iterPos;
+			}
+		}
+	};
+	auto runClustering = [&collapserObj,&clusters,&pars,&alignerObj,&setUp,&preAligner](const CollapseIterations & iterMap){
+		//the pairs ruled out by pre-aligning were ruled out against the sequences the clusters had before clustering, with --debug the
+		//same clustering is also run without them on a copy to check that no consensus rebuilt along the way changed the outcome
+		const bool checkEquivalence = setUp.pars_.debug_ && CollapsePreAligner::hasAddedChecks(clusters);
+		std::vector<cluster> unfilteredClusters;
+		if(checkEquivalence){
+			unfilteredClusters = CollapsePreAligner::copyWithoutAddedChecks(clusters);
+		}
+		//snapshots are written by runFullClustering itself after each iteration, it has no per iteration hook to hand them to a
+		//background writer and splitting the iterations into separate calls changes the clustering, so they stay synchronous
+		collapserObj.runFullClustering(clusters, iterMap,
+				pars.binIteratorMap, alignerObj, setUp.pars_.directoryName_,
+				setUp.pars_.ioOptions_, setUp.pars_.refIoOptions_, pars.snapShotsOpts_);
+		preAligner.removeAddedChecks(clusters);
+		if(checkEquivalence){
+			auto unfilteredSnapShotsOpts = pars.snapShotsOpts_;
+			unfilteredSnapShotsOpts.snapShots_ = false;
+			collapserObj.runFullClustering(unfilteredClusters, iterMap,
+					pars.binIteratorMap, alignerObj, setUp.pars_.directoryName_,
+					setUp.pars_.ioOptions_, setUp.pars_.refIoOptions_, unfilteredSnapShotsOpts);
+			std::stringstream clusterDiffs;
+			if(!CollapsePreAligner::sameClusters(unfilteredClusters, clusters, clusterDiffs)){
+				std::stringstream ss;
+				ss << __PRETTY_FUNCTION__ << ", error clustering with the pre-align checks differs from clustering without them" << "\n";
+				ss << clusterDiffs.str();
+				throw std::runtime_error{ss.str()};
+			}
+			setUp.rLog_ << "Clustering with the pre-align checks matched clustering without them" << "\n";
+		}
+	};
 	setUp.rLog_.logCurrentTime("Running initial clustering");
 	//run clustering
+	preAlignForClustering(pars.intialParameters);
 	pars.snapShotsOpts_.snapShotsDirName_ = "firstSnaps";
-	collapserObj.runFullClustering(clusters, pars.intialParameters,
-			pars.binIteratorMap, alignerObj, setUp.pars_.directoryName_,
-			setUp.pars_.ioOptions_, setUp.pars_.refIoOptions_, pars.snapShotsOpts_);
+	runClustering(pars.intialParameters);
 	//run again with singlets if needed
 	if (!pars.startWithSingles && !pars.leaveOutSinglets) {
 		setUp.rLog_.logCurrentTime("Running singlet clustering");
 		addOtherVec(clusters, singletons);
+		preAlignForClustering(pars.iteratorMap);
 		pars.snapShotsOpts_.snapShotsDirName_ = "secondSnaps";
-		collapserObj.runFullClustering(clusters, pars.iteratorMap,
-				pars.binIteratorMap, alignerObj, setUp.pars_.directoryName_,
-				setUp.pars_.ioOptions_, setUp.pars_.refIoOptions_, pars.snapShotsOpts_);
+		runClustering(pars.iteratorMap);
 	}
 
 	//run again with re-calculating kmer frequencies
 	if(!pars.dontRecalLowFreqMismatchAndReRun){
 		setUp.rLog_.logCurrentTime("Running poster clustering with re-calc k-mer frequencies");
 
-		KmerMaps recalcKmaps = indexKmers(clusters,
-				setUp.pars_.colOpts_.kmerOpts_.kLength_,
-				setUp.pars_.colOpts_.kmerOpts_.runCutOff_,
-				setUp.pars_.colOpts_.kmerOpts_.kmersByPosition_,
-				setUp.pars_.expandKmerPos_,
-				setUp.pars_.expandKmerSize_);
-		alignerObj.kMaps_ = recalcKmaps;
+		//only the kmers of the sequences whose counts changed while clustering get re-counted, straight into the aligner's kmer maps
+		auto seqsRecounted = incKmerCounts.update(clusters, alignerObj.kMaps_);
+		setUp.rLog_ << "Re-counted kmers for " << seqsRecounted << " sequences" << "\n";
+		if(setUp.pars_.debug_){
+			//check the updated maps against a full re-index
+			KmerMaps recalcKmaps = indexKmers(clusters,
+					setUp.pars_.colOpts_.kmerOpts_.kLength_,
+					setUp.pars_.colOpts_.kmerOpts_.runCutOff_,
+					setUp.pars_.colOpts_.kmerOpts_.kmersByPosition_,
+					setUp.pars_.expandKmerPos_,
+					setUp.pars_.expandKmerSize_);
+			std::stringstream kmerDiffs;
+			if(!IncrementalKmerCounts::sameCounts(recalcKmaps, alignerObj.kMaps_, kmerDiffs)){
+				std::stringstream ss;
+				ss << __PRETTY_FUNCTION__ << ", error updated kmer counts don't match re-indexing" << "\n";
+				ss << kmerDiffs.str();
+				throw std::runtime_error{ss.str()};
+			}
+		}
 		pars.snapShotsOpts_.snapShotsDirName_ = "thirdSnaps";
-		njh::for_each(clusters,[](cluster & clus){
-			clus.previousErrorChecks_.clear();
-		});
-		collapserObj.runFullClustering(clusters, pars.iteratorMap,
-				pars.binIteratorMap, alignerObj, setUp.pars_.directoryName_,
-				setUp.pars_.ioOptions_, setUp.pars_.refIoOptions_, pars.snapShotsOpts_);
+		//previous comparisons are only stale if a kmer changed low frequency status, when one did all of them are cleared same as
+		//before since a check is stored under the other cluster's name which doesn't stay the same as clusters merge
+		if(incKmerCounts.statusChanged()){
+			for(auto & clus : clusters){
+				clus.previousErrorChecks_.clear();
+			}
+		}
+		preAlignForClustering(pars.iteratorMap);
+		runClustering(pars.iteratorMap);
 	}
 
+	//run a task that only touches one cluster at a time over every cluster, across threads each with their own aligner if there's more than one thread
+	auto runPerCluster = [&clusters,&alignerObj,&pars,&setUp](const std::function<void(uint32_t, aligner &)> & clusterTask,
+			const bfs::path & scratchDir){
+		if(pars.numThreads <= 1 || clusters.size() <= 1){
+			for(const auto clusPos : iter::range(clusters.size())){
+				clusterTask(clusPos, alignerObj);
+			}
+			return;
+		}
+		std::vector<uint32_t> clusterPositions(clusters.size());
+		njh::iota<uint32_t>(clusterPositions, 0);
+		njh::concurrent::LockableQueue<uint32_t> clusterQueue(clusterPositions);
+		{
+			concurrent::AlignerPool alnPool(alignerObj, pars.numThreads);
+			alnPool.initAligners();
+			alnPool.outAlnDir_ = scratchDir.string();
+			std::function<void()> runTasks = [&clusterQueue,&alnPool,&clusterTask](){
+				auto currentAligner = alnPool.popAligner();
+				uint32_t clusPos = 0;
+				while(clusterQueue.getVal(clusPos)){
+					clusterTask(clusPos, *currentAligner);
+				}
+			};
+			njh::concurrent::runVoidFunctionThreaded(runTasks, pars.numThreads);
+		}
+		//the pool writes out each aligner's cache to scratchDir when it is destroyed
+		alignerObj.processAlnInfoInput(scratchDir.string(), setUp.pars_.verbose_);
+		njh::files::rmDirForce(scratchDir);
+	};
+
 	if(pars.breakoutClusters){
 		std::vector<cluster> breakoutClusters;
-		for(auto & clus : clusters){
-			auto currentBreakOuts = clus.breakoutClustersBasedOnSnps(alignerObj, pars.breakoutPars);
+		//each cluster's break outs are kept separate so they're added back in the same order no matter which thread finished first
+		std::vector<std::vector<cluster>> breakoutsPerCluster(clusters.size());
+		runPerCluster([&clusters,&breakoutsPerCluster,&pars](uint32_t clusPos, aligner & currentAligner){
+			breakoutsPerCluster[clusPos] = clusters[clusPos].breakoutClustersBasedOnSnps(currentAligner, pars.breakoutPars);
+		}, njh::files::make_path(setUp.pars_.directoryName_, "breakoutAlnCache"));
+		for(auto & currentBreakOuts : breakoutsPerCluster){
 			addOtherVec(breakoutClusters, currentBreakOuts);
 		}
 		if(!breakoutClusters.empty()){
@@ -570,6 +765,14 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 				setUp.pars_.directoryName_ + "chimeraNumberInfo.txt", ".txt", false, false);
 		chimerasInfoFile << "#chimericClusters\t#chimericReads" << std::endl;
 		setUp.pars_.chiOpts_.chiOverlap_.largeBaseIndel_ = .99;
+		if (pars.numThreads > 1 && !setUp.pars_.colOpts_.alignOpts_.noAlign_) {
+			//the parent search itself is serial so align each cluster to its possible parents across threads first
+			preAligner.pars_.maxEdits_ = std::numeric_limits<uint32_t>::max();
+			auto chiParentPairs = CollapsePreAligner::getChimeraParentPairs(clusters, setUp.pars_.chiOpts_.parentFreqs_);
+			auto preAlignCounts = preAligner.preAlignPairs(clusters, chiParentPairs, alignerObj,
+					njh::files::make_path(setUp.pars_.directoryName_, "preAlignCache"));
+			setUp.rLog_ << "Pre-aligned " << preAlignCounts.aligned_ << " possible chimera parent pairs with " << pars.numThreads << " threads" << "\n";
+		}
 
 //		collapserObj.opts_.verboseOpts_.verbose_ = true;
 //		collapserObj.opts_.verboseOpts_.debug_ = true;
@@ -634,6 +837,29 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 //		startingInfo << clus.seqBase_.name_ << "\t" << clus.firstReadName_ << "\t"
 //				<< toks.back() << std::endl;
 //	}
+	{
+		//record the size of the final clusters so processClusters doesn't have to read every sample's clusters just to size its aligner
+		uint64_t maxLength = 0;
+		uint64_t minLength = std::numeric_limits<uint64_t>::max();
+		double readCount = 0;
+		for(const auto & clus : clusters){
+			maxLength = std::max<uint64_t>(maxLength, len(clus));
+			minLength = std::min<uint64_t>(minLength, len(clus));
+			readCount += clus.seqBase_.cnt_;
+		}
+		if(clusters.empty()){
+			minLength = 0;
+		}
+		metaData["outputFile"] = njh::json::toJson(setUp.pars_.ioOptions_.out_.outFilename_.string() + setUp.pars_.ioOptions_.getOutExtension());
+		metaData["maxLength"] = njh::json::toJson(maxLength);
+		metaData["minLength"] = njh::json::toJson(minLength);
+		metaData["readCount"] = njh::json::toJson(readCount);
+		metaData["clusterCount"] = njh::json::toJson(clusters.size());
+		metaData["inputReadCount"] = njh::json::toJson(counter);
+		metaData["uniqueSeqCount"] = njh::json::toJson(readDedup.size());
+		OutputStream metaDataOut(njh::files::make_path(setUp.pars_.directoryName_, "metaData.json"));
+		metaDataOut << metaData << std::endl;
+	}
 	if (pars.additionalOut) {
 		auto fnp = setUp.pars_.ioOptions_.firstName_.filename().string();
 		if (njh::endsWith(fnp, ".gz")) {
@@ -684,17 +910,18 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 		setUp.rLog_.logCurrentTime("Calling internal snps");
 		std::string snpDir = njh::files::makeDir(setUp.pars_.directoryName_,
 				njh::files::MkdirPar("internalSnpInfo", false)).string();
-		for (const auto readPos : iter::range(clusters.size())) {
+		//each cluster's table goes to its own file so they can be called and written at the same time
+		runPerCluster([&clusters,&snpDir](uint32_t readPos, aligner & currentAligner){
 			std::unordered_map<uint32_t,
 					std::unordered_map<char, std::vector<baseReadObject>>>mismatches;
 
 			for (const auto subReadPos : iter::range(
 							clusters[readPos].reads_.size())) {
 				const auto & subRead = clusters[readPos].reads_[subReadPos];
-				alignerObj.alignCacheGlobal(clusters[readPos], subRead);
+				currentAligner.alignCacheGlobal(clusters[readPos], subRead);
 				//count gaps and mismatches and get identity
-				alignerObj.profilePrimerAlignment(clusters[readPos], subRead);
-				for (const auto & m : alignerObj.comp_.distances_.mismatches_) {
+				currentAligner.profilePrimerAlignment(clusters[readPos], subRead);
+				for (const auto & m : currentAligner.comp_.distances_.mismatches_) {
 					mismatches[m.second.refBasePos][m.second.seqBase].emplace_back(
 							subRead->seqBase_);
 				}
@@ -721,7 +948,7 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 			misTab.outPutContents(
 					TableIOOpts(OutOptions(snpDir + clusters[readPos].seqBase_.name_,
 							".tab.txt"), "\t", misTab.hasHeader_));
-		}
+		}, njh::files::make_path(setUp.pars_.directoryName_, "internalSnpAlnCache"));
 	}
 
 	if (pars.writeOutFinalAllByAllComparison){
@@ -841,28 +1068,14 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 
 	if(pars.countIlluminaSampleNumbers_){
 		OutputStream sampleCountsOut(njh::files::make_path(setUp.pars_.directoryName_, "illuminaSampleNumbersCounts.tab.txt"));
-		SeqInput reader(inputOpts);
-		reader.openIn();
-		seqInfo inSeq;
 		sampleCountsOut << "SeqName\tsampleNumber\tcount\tfrac" << std::endl;
 		for (const auto& clus : clusters) {
 			std::unordered_map<std::string, uint32_t> sampleNumberCounts;
 			double total = 0;
 			for (const auto & seq : clus.reads_) {
-
-				for (const auto seqPos : filepositions[clusterNameToFilePosKey[seq->seqBase_.name_]]) {
-					reader.seekgPri(seqPos);
-					reader.readNextRead(inSeq);
-					std::string name = inSeq.name_;
-					if(njh::endsWith(name, "_Comp")){
-						name = name.substr(0, name.rfind("_Comp"));
-					}
-					std::shared_ptr<IlluminaNameFormatDecoder> nameDecoded=std::make_shared<IlluminaNameFormatDecoder>(name, pars.IlluminaSampleRegPatStr_, pars.IlluminaSampleNumberPos_);
-					if(0 == nameDecoded->match_.size()){
-						nameDecoded =std::make_shared<IlluminaNameFormatDecoder>(name, pars.BackUpIlluminaSampleRegPatStr_, pars.BackUpIlluminaSampleNumberPos_);
-					}
-					++sampleNumberCounts[nameDecoded->getSampleNumber()];
-					++total;
+				for (const auto & uniqueCount : uniqueSampleNumberCounts[clusterNameToFilePosKey[seq->seqBase_.name_]]) {
+					sampleNumberCounts[uniqueCount.first] += uniqueCount.second;
+					total += uniqueCount.second;
 				}
 			}
 
@@ -937,7 +1150,7 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 			clusMeta.addMeta("clusterName", clus.seqBase_.name_);
 			uint32_t currentCompAmount = 0;
 			for (const auto & seq : clus.reads_) {
-				for (const auto seqPos : filepositions[clusterNameToFilePosKey[seq->seqBase_.name_]]) {
+				for (const auto seqPos : readDedup.getPositions(clusterNameToFilePosKey[seq->seqBase_.name_])) {
 					reader.seekgPri(seqPos);
 					reader.readNextRead(inSeq);
 					if (setUp.pars_.colOpts_.iTOpts_.removeLowQualityBases_) {
@@ -998,6 +1211,10 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 		setUp.rLog_.logCurrentTime("Writing previous alignments");
 		alignerObj.alnHolder_.write(setUp.pars_.outAlnInfoDirName_, setUp.pars_.verbose_);
 	}
+	if (nullptr != sharedAlnCache) {
+		setUp.rLog_.logCurrentTime("Publishing shared alignments");
+		sharedAlnCache->publish(alignerObj, setUp.pars_.verbose_);
+	}
 	if(bfs::exists(tempOutFnp)){
 		bfs::remove(tempOutFnp);
 	}
@@ -1013,6 +1230,11 @@ int SeekDeepRunner::clusterDown(const njh::progutils::CmdArgs & inputCommands) {
 		//log time
 		setUp.logRunTime(std::cout);
 	}
+	if(nullptr != toolsPool){
+		//alignments aren't carried over to the next input so they don't end up written out or published with its alignments
+		alignerObj.alnHolder_ = alnInfoMasterHolder(setUp.pars_.gapInfo_, setUp.pars_.scoring_);
+		toolsPool->checkIn(toolsKey, std::move(tools));
+	}
 
 	return 0;
 }
@@ -160,6 +160,8 @@ void SeekDeepSetUp::setUpClusterDown(clusterDownPars & pars) {
 		tempOut.str(std::string());
 		exit(0);
 	}
+	//help is printed by finishSetUp(), but in a batch run fail here before any of the option checks below can fail first
+	throwIfHelpInsteadOfExit();
 	description_ = "Cluster input sequences by collapsing on set differences between the sequences";
 	examples_.emplace_back("MASTERPROGRAM SUBPROGRAM --fastq inputSeqs.fastq --par parFile.txt");
 	examples_.emplace_back("MASTERPROGRAM SUBPROGRAM --fastq inputSeqs.fastq --illumina   #use default Illumina parameters for collapsing instead of supplying a parameters file");
@@ -382,7 +384,7 @@ void SeekDeepSetUp::setUpClusterDown(clusterDownPars & pars) {
 
 
 
-	setOption(pars.snapShotsOpts_.snapShots_, "--snapShots", "Output Snap Shots of clustering results after each iteration", false, "Additional Output");
+	setOption(pars.snapShotsOpts_.snapShots_, "--snapShots", "Output Snap Shots of clustering results after each iteration, these are written during clustering so they add their write time to each iteration", false, "Additional Output");
 	setOption(pars.sortBy, "--sortBy", "Sort Clusters By");
 	pars.additionalOut = setOption(pars.additionalOutLocationFile,
 			"--additionalOut", "Additional out filename for sorting final results", false, "Additional Output");
@@ -393,6 +395,12 @@ void SeekDeepSetUp::setUpClusterDown(clusterDownPars & pars) {
 	processSkipOnNucComp();
 	setOption(pars_.colOpts_.clusOpts_.converge_, "--converge", "Keep clustering at each iteration until there is no more collapsing, could increase run time significantly", false, "Clustering");
 	setOption(pars.writeOutInitalSeqs, "--writeOutInitalSeqs", "Write out the sequences that make up each cluster", false, "Additional Output");
+	setOption(pars.numThreads, "--numThreads", "Number of threads to use to align candidate clusters ahead of each round of clustering, possible chimera parents ahead of chimera checking, and each cluster when breaking out clusters or calling internal snps, results are the same regardless of the number of threads", false, "Running");
+	if(0 == pars.numThreads){
+		failed_ = true;
+		addWarning("--numThreads should be at least 1");
+	}
+	setOption(pars.sharedAlnCacheDir, "--sharedAlnCacheDir", "A directory of alignments to load and add to, can be shared by many qluster and processClusters runs (even at the same time), alignments are only shared between runs with the same alignment parameters", false, "Alignment");
 	pars_.colOpts_.verboseOpts_.verbose_ = pars_.verbose_;
 	pars_.colOpts_.verboseOpts_.debug_ = pars_.debug_;
 	processRefFilename();
@@ -411,18 +419,10 @@ void SeekDeepSetUp::setUpClusterDown(clusterDownPars & pars) {
 	}
 	if (!failed_) {
 		if ("" != pars.parameters) {
-			if (pars.onPerId) {
-				pars.iteratorMap = processIteratorMapOnPerId(pars.parameters);
-			} else {
-				pars.iteratorMap = processIteratorMap(pars.parameters);
-			}
+			pars.iteratorMap = processIteratorMapShared(pars.parameters, pars.onPerId);
 		}
 		if ("" != pars.binParameters) {
-			if (pars.onPerId) {
-				pars.binIteratorMap = processIteratorMapOnPerId(pars.binParameters);
-			} else {
-				pars.binIteratorMap = processIteratorMap(pars.binParameters);
-			}
+			pars.binIteratorMap = processIteratorMapShared(pars.binParameters, pars.onPerId);
 		} else if("" != pars.parameters){
 			//set to reg iter map if it was set by --par flag
 			pars.binIteratorMap = pars.iteratorMap;
@@ -447,5 +447,24 @@ void SeekDeepSetUp::setUpClusterDown(clusterDownPars & pars) {
 	finishSetUp(std::cout);
 }
 
+void SeekDeepSetUp::setUpQlusterBatch(QlusterBatchPars & pars) {
+	description_ = "Run qluster on many inputs within one process, scheduling the inputs across a single pool of threads and reading each parameters file once";
+	examples_.emplace_back("MASTERPROGRAM SUBPROGRAM --batchTable inputs.tab.txt --par pars.tab.txt --qlusterArgs \"--illumina --qualThres 25,20\" --numThreads 8");
+	processVerbose();
+	processDebug();
+	setOption(pars.batchTableFnp, "--batchTable",
+			"A tab delimited table with a header, needs columns dout and input, "
+			"can also have columns par (parameters file for that input) and extraArgs (space separated arguments added for that input only)", true, "Input");
+	setOption(pars.parFnp, "--par", "The parameters file to use for any inputs that don't have one in the par column of --batchTable", false, "Input");
+	setOption(pars.qlusterArgs, "--qlusterArgs", "Space separated arguments to pass to every qluster run", false, "Input");
+	setOption(pars.numThreads, "--numThreads", "Number of inputs to cluster at once, with more than one the clusterings run without verbose output", false, "Running");
+	if(0 == pars.numThreads){
+		failed_ = true;
+		addWarning("--numThreads should be at least 1");
+	}
+	processDirectoryOutputName("qlusterBatch_" + getCurrentDate(), true);
+	finishSetUp(std::cout);
+}
+
 }   // namespace njhseq
 
@@ -0,0 +1,93 @@
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "SeekDeepPrograms/SeekDeepProgram/SeekDeepRunner.hpp"
+namespace njhseq {
+
+
+
+int SeekDeepRunner::qlusterBatch(const njh::progutils::CmdArgs & inputCommands) {
+	SeekDeepSetUp setUp(inputCommands);
+	QlusterBatchPars pars;
+	setUp.setUpQlusterBatch(pars);
+	// run log
+	setUp.startARunLog(setUp.pars_.directoryName_);
+	// parameter file
+	setUp.writeParametersFile(setUp.pars_.directoryName_ + "parametersUsed.txt", false, false);
+
+	BatchRunner batch(pars.batchTableFnp, VecStr{"dout", "input"});
+	auto commonArgs = njh::tokenizeString(pars.qlusterArgs, "whitespace");
+	for(const auto & row : batch.batchTab_){
+		BatchRunner::Run run;
+		run.dout_ = batch.getValue(row, "dout");
+		bfs::path input = batch.getValue(row, "input");
+		batch.checkExists(run.dout_, "input", input);
+		bfs::path parFnp = pars.parFnp;
+		if("" != batch.getValue(row, "par")){
+			parFnp = batch.getValue(row, "par");
+		}
+		run.args_ = VecStr{setUp.commands_.masterProgram_, "qluster", BatchRunner::singleEndInputFlag(input), input.string(), "--dout", run.dout_};
+		//everything after the input and output determines how the clustering is set up so rows with the same arguments can share an aligner and collapser
+		VecStr clusteringArgs;
+		if("" != parFnp.string()){
+			batch.checkExists(run.dout_, "parameters file", parFnp);
+			clusteringArgs.emplace_back("--par");
+			clusteringArgs.emplace_back(parFnp.string());
+		}
+		addOtherVec(clusteringArgs, commonArgs);
+		addOtherVec(clusteringArgs, njh::tokenizeString(batch.getValue(row, "extraargs"), "whitespace"));
+		run.sharedKey_ = njh::conToStr(clusteringArgs, " ");
+		addOtherVec(run.args_, clusteringArgs);
+		batch.addRun(run);
+	}
+	batch.throwIfRowErrors();
+	if(setUp.pars_.verbose_){
+		std::cout << "Clustering " << batch.runs_.size() << " inputs with " << pars.numThreads << " threads" << std::endl;
+	}
+
+	//each row gets its own set up (which throws rather than exits on a bad argument), the parameters files are parsed within the set up
+	//so each is read with that row's --onPerId but only once per process, and a finished row hands its aligner and collapser on to the
+	//next row with the same arguments
+	ReusePool<ClusterDownTools> toolsPool(pars.numThreads);
+	const bool quietRows = pars.numThreads > 1;
+	batch.runAll([&toolsPool,&quietRows](BatchRunner::Run & run, const njh::progutils::CmdArgs & commands){
+		SeekDeepSetUp runSetUp(commands);
+		runSetUp.throwInsteadOfExit_ = true;
+		runSetUp.quiet_ = quietRows;
+		clusterDownPars runPars;
+		runSetUp.setUpClusterDown(runPars);
+		return runClusterDown(runSetUp, runPars, &toolsPool, run.sharedKey_);
+	}, pars.numThreads, setUp.pars_.verbose_);
+
+	auto batchRunsFnp = njh::files::make_path(setUp.pars_.directoryName_, "qlusterBatchRuns.tab.txt");
+	uint32_t failedCount = batch.writeRunsTable(batchRunsFnp);
+	if(failedCount > 0){
+		std::cerr << failedCount << " of " << batch.runs_.size() << " clusterings failed, see " << batchRunsFnp << std::endl;
+	}
+	if(setUp.pars_.verbose_){
+		setUp.logRunTime(std::cout);
+	}
+	return 0 == failedCount ? 0 : 1;
+}
+
+
+
+}  // namespace njhseq
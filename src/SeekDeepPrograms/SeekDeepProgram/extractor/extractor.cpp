@@ -35,20 +35,16 @@ int SeekDeepRunner::extractor(const njh::progutils::CmdArgs & inputCommands) {
 	SeekDeepSetUp setUp(inputCommands);
 	extractorPars pars;
 	setUp.setUpExtractor(pars);
+	auto ids = genExtractorIds(pars, setUp.pars_.verbose_);
+	return runExtractor(setUp, pars, ids);
+}
 
-	uint32_t readsNotMatchedToBarcode = 0;
-	uint32_t readsNotMatchedToBarcodePossContam = 0;
-
-	// run log
-	setUp.startARunLog(setUp.pars_.directoryName_);
-	// parameter file
-	setUp.writeParametersFile(setUp.pars_.directoryName_ + "parametersUsed.txt", false, false);
-
+PrimersAndMids SeekDeepRunner::genExtractorIds(const extractorPars & pars, bool verbose) {
 	// create Primers and MIDs
 	PrimersAndMids ids(pars.corePars_.primIdsPars.idFile_);
 
 	ids.checkIfMIdsOrPrimersReadInThrow(__PRETTY_FUNCTION__);
-	if(setUp.pars_.verbose_){
+	if(verbose){
 		if(ids.getMids().size()> 0){
 			std::cout << "Found: " << ids.getMids().size() << " MIDs to de-multiplex on" << std::endl;
 		}
@@ -69,6 +65,28 @@ int SeekDeepRunner::extractor(const njh::progutils::CmdArgs & inputCommands) {
 			throw std::runtime_error { ss.str() };
 		}
 	}
+	return ids;
+}
+
+int SeekDeepRunner::runExtractor(SeekDeepSetUp & setUp, extractorPars & pars, PrimersAndMids & ids) {
+	uint32_t readsNotMatchedToBarcode = 0;
+	uint32_t readsNotMatchedToBarcodePossContam = 0;
+	//per stage timings, written to extractionTimings.json
+	StageTimer timer;
+	const auto readParsingStage = timer.registerStage("readParsing");
+	const auto qualityChecksStage = timer.registerStage("lengthQualityChecks");
+	const auto midSearchStage = timer.registerStage("midSearch");
+	const auto primerSearchStage = timer.registerStage("primerSearch");
+	const auto contamScreeningStage = timer.registerStage("contaminationScreening");
+	const auto writingStage = timer.registerStage("writing");
+	const auto unrecognizedGroup = timer.getGroupId("unrecognizedBarcode");
+	const auto allGroup = timer.getGroupId("all");
+
+	// run log
+	setUp.startARunLog(setUp.pars_.directoryName_);
+	// parameter file
+	setUp.writeParametersFile(setUp.pars_.directoryName_ + "parametersUsed.txt", false, false);
+
 	// make some directories for outputs
 	bfs::path unfilteredReadsDir = njh::files::makeDir(
 			setUp.pars_.directoryName_,
@@ -112,7 +130,7 @@ int SeekDeepRunner::extractor(const njh::progutils::CmdArgs & inputCommands) {
 	uint32_t startsWithBadQualCount = 0;
 	uint64_t maxReadSize = 0;
 	uint32_t count = 0;
-	MultiSeqIO readerOuts;
+	MultiSeqOutPool readerOuts(pars.corePars_.outPoolPars_);
 
 	std::map<std::string, std::pair<uint32_t, uint32_t>> counts;
 	std::unordered_map<std::string, uint32_t>  failBarCodeCounts;
@@ -167,7 +185,7 @@ int SeekDeepRunner::extractor(const njh::progutils::CmdArgs & inputCommands) {
 	std::vector<size_t> readLens;
 
 
-	while (reader.readNextRead(seq)) {
+	while (timer.time(readParsingStage, StageTimer::noGroup_, [&reader,&seq](){ return reader.readNextRead(seq);})) {
 		++count;
 		if (setUp.pars_.verbose_ && count % 50 == 0) {
 			std::cout << "\r" << count ;
@@ -176,42 +194,51 @@ int SeekDeepRunner::extractor(const njh::progutils::CmdArgs & inputCommands) {
 		readVec::handelLowerCaseBases(seq, setUp.pars_.ioOptions_.lowerCaseBases_);
 
 		//possibly trim reads at low quality
+		StageTimer::Lap preFilterLap(timer, qualityChecksStage, StageTimer::noGroup_);
 		if(pars.trimAtQual){
 			readVecTrimmer::trimAtFirstQualScore(seq->seqBase_, pars.trimAtQualCutOff);
 			if(0 == len(*seq)){
-				startsWtihBadQualOut.openWrite(seq);
+				preFilterLap.stop();
+				timer.time(writingStage, StageTimer::noGroup_, [&startsWtihBadQualOut,&seq](){ startsWtihBadQualOut.openWrite(seq);});
 				++startsWithBadQualCount;
 				continue;
 			}
 		}
 
 		if (len(*seq) < pars.corePars_.smallFragmentCutoff) {
-			smallFragMentOut.write(seq);
+			preFilterLap.stop();
+			timer.time(writingStage, StageTimer::noGroup_, [&smallFragMentOut,&seq](){ smallFragMentOut.write(seq);});
 			++smallFragmentCount;
 			continue;
 		}
 		readVec::getMaxLength(seq, maxReadSize);
-
+		preFilterLap.stop();
 
 		if (ids.containsMids()) {
-			auto searchRes = ids.mDeterminator_->searchRead(seq->seqBase_);
-			auto processRes = ids.mDeterminator_->processSearchRead(seq->seqBase_, searchRes);
+			StageTimer::Lap midLap(timer, midSearchStage, StageTimer::noGroup_);
+			auto processRes = ids.searchAndProcessMid(seq->seqBase_);
 			if(MidDeterminator::ProcessedRes::PROCESSED_CASE::MATCH == processRes.case_){
+				const auto midGroup = timer.getGroupId(processRes.midName_);
+				midLap.setGroup(midGroup);
+				midLap.stop();
 				if (processRes.rcomplement_) {
 					++counts[processRes.midName_].second;
 				} else {
 					++counts[processRes.midName_].first;
 				}
 				readLens.emplace_back(len(*seq));
-				readerOuts.openWrite(processRes.midName_, seq);
+				timer.time(writingStage, midGroup, [&readerOuts,&processRes,&seq](){ readerOuts.openWrite(processRes.midName_, seq);});
 			}else{
+				midLap.setGroup(unrecognizedGroup);
+				midLap.stop();
 				std::string unRecName = "unrecognizedBarcode_" + MidDeterminator::ProcessedRes::getProcessedCaseName(processRes.case_);
 				bool possibleContaimination = false;
 				if(ids.screeningForPossibleContamination()){
+					StageTimer::Lap contamLap(timer, contamScreeningStage, unrecognizedGroup);
 					//this will check the read against all targets and their reverse complement so it will be a conservative estimate
 					//of whether or not this is contamination, if the read is still on by the end then that it means it's not
 					//considered possible contamination, could mark a lot seqs as contamination if not all seqs have comparison seqs
-					kmerInfo seqKInfo(seq->seqBase_.seq_, pars.corePars_.primIdsPars.compKmerLen_, false);
+					PackedKmerSet seqKInfo(seq->seqBase_.seq_, pars.corePars_.primIdsPars.compKmerLen_, false);
 					seq->seqBase_.on_ = false;
 					for(const auto & tar : ids.targets_){
 						for(const auto & refInfo : tar.second.refKInfos_){
@@ -233,19 +260,19 @@ int SeekDeepRunner::extractor(const njh::progutils::CmdArgs & inputCommands) {
 					++readsNotMatchedToBarcode;
 					++failBarCodeCounts[MidDeterminator::ProcessedRes::getProcessedCaseName(processRes.case_)];
 				}
-				readerOuts.openWrite(unRecName, seq);
+				timer.time(writingStage, unrecognizedGroup, [&readerOuts,&unRecName,&seq](){ readerOuts.openWrite(unRecName, seq);});
 			}
 		} else {
 			++counts["all"].first;
 			readLens.emplace_back(len(*seq));
-			readerOuts.openWrite("all", seq);
+			timer.time(writingStage, allGroup, [&readerOuts,&seq](){ readerOuts.openWrite("all", seq);});
 		}
 	}
 	if (setUp.pars_.verbose_) {
 		std::cout << std::endl;
 	}
 	//close mid outs;
-	readerOuts.closeOutAll();
+	timer.time(writingStage, StageTimer::noGroup_, [&readerOuts](){ readerOuts.closeOutAll();}, true);
 
 	//if no length was supplied, calculate a min and max length off of the median read length
 	auto readLenMedian = vectorMedianRef(readLens);
@@ -393,7 +420,7 @@ int SeekDeepRunner::extractor(const njh::progutils::CmdArgs & inputCommands) {
 		barcodeIn.openIn();
 
 		//create outputs
-		MultiSeqIO midReaderOuts;
+		MultiSeqOutPool midReaderOuts(pars.corePars_.outPoolPars_);
 		auto unrecogPrimerOutOpts = setUp.pars_.ioOptions_;
 		unrecogPrimerOutOpts.out_.outFilename_ = njh::files::make_path(unrecognizedPrimerDir
 				,barcodeName).string();
@@ -426,8 +453,14 @@ int SeekDeepRunner::extractor(const njh::progutils::CmdArgs & inputCommands) {
 		njh::ProgressBar pbar(
 				counts[barcodeName].first + counts[barcodeName].second);
 		pbar.progColors_ = pbar.RdYlGn_;
-
-		while (barcodeIn.readNextRead(seq)) {
+		//writes are timed under the MID since the target isn't always known
+		const auto barcodeGroup = timer.getGroupId(barcodeName);
+		auto timedWrite = [&timer,&midReaderOuts,&seq,&writingStage,&barcodeGroup](const std::string & outName){
+			StageTimer::Lap writeLap(timer, writingStage, barcodeGroup);
+			midReaderOuts.openWrite(outName, seq);
+		};
+
+		while (timer.time(readParsingStage, barcodeGroup, [&barcodeIn,&seq](){ return barcodeIn.readNextRead(seq);})) {
 			if(setUp.pars_.verbose_){
 				pbar.outputProgAdd(std::cout, 1, true);
 			}
@@ -456,6 +489,7 @@ int SeekDeepRunner::extractor(const njh::progutils::CmdArgs & inputCommands) {
 					primerCheckComplement = true;
 				}
 				//front end primer
+				StageTimer::Lap primerLap(timer, primerSearchStage, barcodeGroup);
 				frontPrimerName = ids.pDeterminator_->determineForwardPrimer(seq, pars.corePars_.pDetPars, alignObj);
 				if (frontPrimerName == "unrecognized" && primerCheckComplement) {
 					frontPrimerName = ids.pDeterminator_->determineWithReversePrimer(seq, pars.corePars_.pDetPars, alignObj);
@@ -464,8 +498,9 @@ int SeekDeepRunner::extractor(const njh::progutils::CmdArgs & inputCommands) {
 					}
 				}
 				if ("unrecognized" == frontPrimerName) {
+					primerLap.stop();
 					stats.increaseFailedForward(barcodeName, seq->seqBase_.name_);
-					midReaderOuts.openWrite("unrecognized", seq);
+					timedWrite("unrecognized");
 					continue;
 				}
 
@@ -487,6 +522,7 @@ int SeekDeepRunner::extractor(const njh::progutils::CmdArgs & inputCommands) {
 				}else{
 					backPrimerName = frontPrimerName;
 				}
+				primerLap.stop();
 
 
 				std::string primerName = "";
@@ -511,15 +547,17 @@ int SeekDeepRunner::extractor(const njh::progutils::CmdArgs & inputCommands) {
 					}else{
 						seq->seqBase_.name_.append("[backPrimer=" + backPrimerName + "]");
 					}
-					midReaderOuts.openWrite(fullname + "bad", seq);
+					timedWrite(fullname + "bad");
 					continue;
 				}
 			}
 
 			//look for possible contamination
+			const auto targetGroup = timer.getGroupId(fullname);
 			if (!njh::mapAt(ids.targets_, targetName).refKInfos_.empty() ) {
+				StageTimer::Lap contamLap(timer, contamScreeningStage, targetGroup);
 				bool contamination = true;
-				kmerInfo seqKInfo(seq->seqBase_.seq_, pars.corePars_.primIdsPars.compKmerLen_, false);
+				PackedKmerSet seqKInfo(seq->seqBase_.seq_, pars.corePars_.primIdsPars.compKmerLen_, false);
 				for(const auto & refInfo : ids.targets_.at(targetName).refKInfos_){
 					if(refInfo.compareKmers(seqKInfo).second >= pars.corePars_.primIdsPars.compKmerSimCutOff_){
 						contamination = false;
@@ -529,21 +567,24 @@ int SeekDeepRunner::extractor(const njh::progutils::CmdArgs & inputCommands) {
 				if(contamination){
 					seq->seqBase_.on_ = false;
 				}
+				contamLap.stop();
 				if (!seq->seqBase_.on_) {
 					stats.increaseCounts(fullname, seq->seqBase_.name_,
 							ExtractionStator::extractCase::CONTAMINATION);
-					midReaderOuts.openWrite(fullname + "contamination", seq);
+					timedWrite(fullname + "contamination");
 					continue;
 				}
 			}
 
 			//min len
+			StageTimer::Lap qcLap(timer, qualityChecksStage, targetGroup);
 			ids.targets_.at(targetName).lenCuts_->minLenChecker_.checkRead(seq->seqBase_);
 
 			if (!seq->seqBase_.on_) {
+				qcLap.stop();
 				stats.increaseCounts(fullname, seq->seqBase_.name_,
 						ExtractionStator::extractCase::MINLENBAD);
-				midReaderOuts.openWrite(fullname + "bad", seq);
+				timedWrite(fullname + "bad");
 				continue;
 			}
 
@@ -551,30 +592,34 @@ int SeekDeepRunner::extractor(const njh::progutils::CmdArgs & inputCommands) {
 			//contains n
 			nChecker.checkRead(seq->seqBase_);
 			if (!seq->seqBase_.on_) {
+				qcLap.stop();
 				stats.increaseCounts(fullname, seq->seqBase_.name_,
 						ExtractionStator::extractCase::CONTAINSNS);
-				midReaderOuts.openWrite(fullname + "bad", seq);
+				timedWrite(fullname + "bad");
 				continue;
 			}
 
 			//max len
 			ids.targets_.at(targetName).lenCuts_->maxLenChecker_.checkRead(seq->seqBase_);
 			if (!seq->seqBase_.on_) {
+				qcLap.stop();
 				stats.increaseCounts(fullname, seq->seqBase_.name_,
 						ExtractionStator::extractCase::MAXLENBAD);
-				midReaderOuts.openWrite(fullname + "bad", seq);
+				timedWrite(fullname + "bad");
 				continue;
 			}
 			//quality
 			qualChecker->checkRead(seq->seqBase_);
 
 			if (!seq->seqBase_.on_) {
+				qcLap.stop();
 				stats.increaseCounts(fullname, seq->seqBase_.name_,
 						ExtractionStator::extractCase::QUALITYFAILED);
-				midReaderOuts.openWrite(fullname + "bad", seq);
+				timedWrite(fullname + "bad");
 				continue;
 			}
 
+			qcLap.stop();
 			if (seq->seqBase_.on_) {
 				stats.increaseCounts(fullname, seq->seqBase_.name_,
 						ExtractionStator::extractCase::GOOD);
@@ -588,10 +633,11 @@ int SeekDeepRunner::extractor(const njh::progutils::CmdArgs & inputCommands) {
 					}
 					renameKeyFile << oldName << "\t" << seq->seqBase_.name_ << "\n";
 				}
-				midReaderOuts.openWrite(fullname + "good", seq);
+				timedWrite(fullname + "good");
 				++goodCounts[fullname];
 			}
 		}
+		timer.time(writingStage, barcodeGroup, [&midReaderOuts](){ midReaderOuts.closeOutAll();}, true);
 		if(setUp.pars_.verbose_){
 			std::cout << std::endl;
 		}
@@ -612,6 +658,7 @@ int SeekDeepRunner::extractor(const njh::progutils::CmdArgs & inputCommands) {
 	}
 	profileLog << "\tcontamination\n";
 	stats.outStatsPerName(profileLog, "\t");
+	timer.writeJson(OutOptions(njh::files::make_path(setUp.pars_.directoryName_, "extractionTimings.json")));
 	std::ofstream extractionStatsFile;
 	openTextFile(extractionStatsFile,
 			setUp.pars_.directoryName_ + "extractionStats.tab.txt", ".txt",
@@ -0,0 +1,137 @@
+//
+// SeekDeep - A library for analyzing amplicon sequence data
+// Copyright (C) 2012-2019 Nicholas Hathaway <nicholas.hathaway@umassmed.edu>,
+// Jeffrey Bailey <Jeffrey.Bailey@umassmed.edu>
+//
+// This file is part of SeekDeep.
+//
+// SeekDeep is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SeekDeep is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SeekDeep.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+//  extractorBatch.cpp
+//  SeekDeep
+//
+//  Created on: Oct 18, 2026
+//
+
+#include "SeekDeepPrograms/SeekDeepProgram/SeekDeepRunner.hpp"
+namespace njhseq {
+
+
+
+int SeekDeepRunner::extractorBatch(const njh::progutils::CmdArgs & inputCommands) {
+	SeekDeepSetUp setUp(inputCommands);
+	ExtractorBatchPars pars;
+	setUp.setUpExtractorBatch(pars);
+	// run log
+	setUp.startARunLog(setUp.pars_.directoryName_);
+	// parameter file
+	setUp.writeParametersFile(setUp.pars_.directoryName_ + "parametersUsed.txt", false, false);
+
+	VecStr requiredColumns{"dout"};
+	if(pars.pairedEnd){
+		requiredColumns.emplace_back("r1");
+		requiredColumns.emplace_back("r2");
+	}else{
+		requiredColumns.emplace_back("input");
+	}
+	BatchRunner batch(pars.batchTableFnp, requiredColumns);
+	auto commonArgs = njh::tokenizeString(pars.extractorArgs, "whitespace");
+	for(const auto & row : batch.batchTab_){
+		BatchRunner::Run run;
+		run.dout_ = batch.getValue(row, "dout");
+		bfs::path idFile = pars.idFile;
+		if("" != batch.getValue(row, "id")){
+			idFile = batch.getValue(row, "id");
+		}
+		if("" == idFile.string()){
+			batch.addRowError(run.dout_, "no id file, need to supply --id or an id column");
+		}else{
+			batch.checkExists(run.dout_, "id file", idFile);
+		}
+		run.args_ = VecStr{setUp.commands_.masterProgram_, pars.pairedEnd ? "extractorPairedEnd" : "extractor"};
+		if(pars.pairedEnd){
+			bfs::path r1 = batch.getValue(row, "r1");
+			bfs::path r2 = batch.getValue(row, "r2");
+			bool gz = njh::endsWith(njh::strToLowerRet(r1.string()), ".gz");
+			run.args_.emplace_back(gz ? "--fastq1gz" : "--fastq1");
+			run.args_.emplace_back(r1.string());
+			run.args_.emplace_back(gz ? "--fastq2gz" : "--fastq2");
+			run.args_.emplace_back(r2.string());
+			batch.checkExists(run.dout_, "input", r1);
+			batch.checkExists(run.dout_, "input", r2);
+		}else{
+			bfs::path input = batch.getValue(row, "input");
+			run.args_.emplace_back(BatchRunner::singleEndInputFlag(input));
+			run.args_.emplace_back(input.string());
+			batch.checkExists(run.dout_, "input", input);
+		}
+		run.args_.emplace_back("--dout");
+		run.args_.emplace_back(run.dout_);
+		//everything after the input and output determines the primers and MIDs set up so rows with the same arguments share them
+		VecStr idArgs{"--id", idFile.string()};
+		addOtherVec(idArgs, commonArgs);
+		addOtherVec(idArgs, njh::tokenizeString(batch.getValue(row, "extraargs"), "whitespace"));
+		run.sharedKey_ = njh::conToStr(idArgs, " ");
+		addOtherVec(run.args_, idArgs);
+		batch.addRun(run);
+	}
+	batch.throwIfRowErrors();
+	if(setUp.pars_.verbose_){
+		std::cout << "Extracting " << batch.runs_.size() << " inputs with " << pars.numThreads << " threads" << std::endl;
+	}
+
+	//each row gets its own set up (which throws rather than exits on a bad argument) and its own copy of the primers and MIDs since extraction
+	//sets per input length cut offs and overlap statuses on the targets. The copies share the determinators and the barcode index, which are
+	//built once per distinct set of arguments per worker thread since the determinators' searches aren't known to be thread safe, so rows
+	//running at the same time never search with the same determinator
+	SharedBuildCache<PrimersAndMids> idsCache;
+	const bool quietRows = pars.numThreads > 1;
+	batch.runAll([&idsCache,&pars,&quietRows](BatchRunner::Run & run, const njh::progutils::CmdArgs & commands){
+		SeekDeepSetUp runSetUp(commands);
+		runSetUp.throwInsteadOfExit_ = true;
+		runSetUp.quiet_ = quietRows;
+		const std::string idsKey = njh::pasteAsStr(run.workerPos_, " ", run.sharedKey_);
+		if(pars.pairedEnd){
+			ExtractorPairedEndPars runPars;
+			runSetUp.setUpExtractorPairedEnd(runPars);
+			auto sharedIds = idsCache.get(idsKey, [&runPars](){
+				return std::make_shared<const PrimersAndMids>(genExtractorPairedEndIds(runPars, false));
+			});
+			PrimersAndMids ids(*sharedIds);
+			return runExtractorPairedEnd(runSetUp, runPars, ids);
+		}
+		extractorPars runPars;
+		runSetUp.setUpExtractor(runPars);
+		auto sharedIds = idsCache.get(idsKey, [&runPars](){
+			return std::make_shared<const PrimersAndMids>(genExtractorIds(runPars, false));
+		});
+		PrimersAndMids ids(*sharedIds);
+		return runExtractor(runSetUp, runPars, ids);
+	}, pars.numThreads, setUp.pars_.verbose_);
+
+	auto batchRunsFnp = njh::files::make_path(setUp.pars_.directoryName_, "extractorBatchRuns.tab.txt");
+	uint32_t failedCount = batch.writeRunsTable(batchRunsFnp);
+	if(failedCount > 0){
+		std::cerr << failedCount << " of " << batch.runs_.size() << " extractions failed, see " << batchRunsFnp << std::endl;
+	}
+	if(setUp.pars_.verbose_){
+		setUp.logRunTime(std::cout);
+	}
+	return 0 == failedCount ? 0 : 1;
+}
+
+
+
+}  // namespace njhseq
@@ -34,15 +34,16 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 	//std::cout << "pars.corePars_.sampleName: " << pars.corePars_.sampleName << std::endl;
 	setUp.setUpExtractorPairedEnd(pars);
 	//std::cout << "pars.corePars_.sampleName: " << pars.corePars_.sampleName << std::endl;
-	// run log
-	setUp.startARunLog(setUp.pars_.directoryName_);
-	// parameter file
-	setUp.writeParametersFile(setUp.pars_.directoryName_ + "parametersUsed.txt", false, false);
+	auto ids = genExtractorPairedEndIds(pars, setUp.pars_.verbose_);
+	return runExtractorPairedEnd(setUp, pars, ids);
+}
+
+PrimersAndMids SeekDeepRunner::genExtractorPairedEndIds(const ExtractorPairedEndPars & pars, bool verbose) {
 	PrimersAndMids ids(pars.corePars_.primIdsPars.idFile_);
 
 
 	ids.checkIfMIdsOrPrimersReadInThrow(__PRETTY_FUNCTION__);
-	if(setUp.pars_.verbose_){
+	if(verbose){
 		if(ids.getMids().size()> 0){
 			std::cout << "Found: " << ids.getMids().size() << " MIDs to de-multiplex on" << std::endl;
 		}
@@ -74,7 +75,14 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 			throw std::runtime_error { ss.str() };
 		}
 	}
+	return ids;
+}
 
+int SeekDeepRunner::runExtractorPairedEnd(SeekDeepSetUp & setUp, ExtractorPairedEndPars & pars, PrimersAndMids & ids) {
+	// run log
+	setUp.startARunLog(setUp.pars_.directoryName_);
+	// parameter file
+	setUp.writeParametersFile(setUp.pars_.directoryName_ + "parametersUsed.txt", false, false);
 	//default checks for Ns and quality
 	ReadCheckerOnSeqContaining nChecker("N", pars.corePars_.numberOfNs, true);
 	ReadCheckerQualCheck qualChecker(pars.corePars_.qPars_.qualCheck_, pars.corePars_.qPars_.qualCheckCutOff_, true);
@@ -121,7 +129,7 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 	uint32_t smallFragmentCount = 0;
 	uint64_t maxReadSize = 0;
 
-	MultiSeqIO readerOuts;
+	MultiSeqOutPool readerOuts(pars.corePars_.outPoolPars_);
 
 	std::map<std::string, std::pair<uint32_t, uint32_t>> counts;
 	std::unordered_map<std::string, uint32_t>  failBarCodeCounts;
@@ -179,12 +187,23 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 	uint32_t contamination = 0;
 	uint32_t qualityFilters = 0;
 	uint32_t used = 0;
+	//per stage timings, written to extractionTimings.json
+	StageTimer timer;
+	const auto readParsingStage = timer.registerStage("readParsing");
+	const auto qualityChecksStage = timer.registerStage("lengthQualityChecks");
+	const auto midSearchStage = timer.registerStage("midSearch");
+	const auto primerSearchStage = timer.registerStage("primerSearch");
+	const auto stitchingStage = timer.registerStage("stitching");
+	const auto contamScreeningStage = timer.registerStage("contaminationScreening");
+	const auto writingStage = timer.registerStage("writing");
+	const auto unrecognizedGroup = timer.getGroupId("unrecognizedBarcode");
+	const auto allGroup = timer.getGroupId("all");
 
 	std::string seqName = bfs::basename(setUp.pars_.ioOptions_.firstName_);
 	seqName = seqName.substr(0,seqName.find("_"));
 
 
-	while (reader.readNextRead(seq)) {
+	while (timer.time(readParsingStage, StageTimer::noGroup_, [&reader,&seq](){ return reader.readNextRead(seq);})) {
 //		std::cout << seq.seqBase_.name_ << std::endl;
 //		bool print = false;
 //		if("M02551:63:000000000-D3YB2:1:1102:10373:15072 1:N:0:1" == seq.seqBase_.name_){
@@ -199,7 +218,7 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 		readVec::handelLowerCaseBases(seq, setUp.pars_.ioOptions_.lowerCaseBases_);
 
 		if (len(seq) < pars.corePars_.smallFragmentCutoff) {
-			smallFragMentOut.openWrite(seq);
+			timer.time(writingStage, StageTimer::noGroup_, [&smallFragMentOut,&seq](){ smallFragMentOut.openWrite(seq);});
 			++smallFragmentCount;
 			continue;
 		}
@@ -207,9 +226,11 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 		readVec::getMaxLength(seq.mateSeqBase_, maxReadSize);
 
 		if (ids.containsMids()) {
-			auto searchRes = ids.mDeterminator_->searchPairedEndRead(seq);
-
-			auto processRes = ids.mDeterminator_->processSearchPairedEndRead(seq, searchRes);
+			StageTimer::Lap midLap(timer, midSearchStage, StageTimer::noGroup_);
+			auto processRes = ids.searchAndProcessMid(seq);
+			const auto midGroup = MidDeterminator::ProcessedRes::PROCESSED_CASE::MATCH == processRes.case_ ? timer.getGroupId(processRes.midName_) : unrecognizedGroup;
+			midLap.setGroup(midGroup);
+			midLap.stop();
 //			if(MidDeterminator::ProcessedRes::PROCESSED_CASE::MISMATCHING_MIDS == processRes.case_){
 //				std::cout << seq.seqBase_.name_ << std::endl;
 //				std::cout << "Forward: ";
@@ -228,16 +249,16 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 				} else {
 					++counts[processRes.midName_].first;
 				}
-				readerOuts.openWrite(processRes.midName_, seq);
+				timer.time(writingStage, midGroup, [&readerOuts,&processRes,&seq](){ readerOuts.openWrite(processRes.midName_, seq);});
 			}else{
 				std::string unRecName = "unrecognizedBarcode_" + MidDeterminator::ProcessedRes::getProcessedCaseName(processRes.case_);
 				++readsNotMatchedToBarcode;
 				++failBarCodeCounts[MidDeterminator::ProcessedRes::getProcessedCaseName(processRes.case_)];
-				readerOuts.openWrite(unRecName, seq);
+				timer.time(writingStage, unrecognizedGroup, [&readerOuts,&unRecName,&seq](){ readerOuts.openWrite(unRecName, seq);});
 			}
 		} else {
 			++counts["all"].first;
-			readerOuts.openWrite("all", seq);
+			timer.time(writingStage, allGroup, [&readerOuts,&seq](){ readerOuts.openWrite("all", seq);});
 		}
 	}
 	if(ids.containsMids()){
@@ -280,7 +301,7 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 		std::cout << std::endl;
 	}
 	//close mid outs;
-	readerOuts.closeOutAll();
+	timer.time(writingStage, StageTimer::noGroup_, [&readerOuts](){ readerOuts.closeOutAll();}, true);
 
 
 	std::ofstream renameKeyFile;
@@ -366,7 +387,7 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 		}
 
 		//create outputs
-		MultiSeqIO midReaderOuts;
+		MultiSeqOutPool midReaderOuts(pars.corePars_.outPoolPars_);
 		auto unrecogPrimerOutOpts = setUp.pars_.ioOptions_;
 		unrecogPrimerOutOpts.out_.outFilename_ = njh::files::make_path(
 				unrecognizedPrimerDir, barcodeName).string();
@@ -394,6 +415,12 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 		uint32_t barcodeCount = 1;
 		njh::ProgressBar pbar(counts[barcodeName].first + counts[barcodeName].second);
 		pbar.progColors_ = pbar.RdYlGn_;
+		//writes are timed under the MID since the target isn't always known
+		const auto barcodeGroup = timer.getGroupId(barcodeName);
+		auto timedWrite = [&timer,&midReaderOuts,&seq,&writingStage,&barcodeGroup](const std::string & outName){
+			StageTimer::Lap writeLap(timer, writingStage, barcodeGroup);
+			midReaderOuts.openWrite(outName, seq);
+		};
 
 		SeqIOOptions barcodePairsReaderOpts = SeqIOOptions::genPairedIn(
 				barcodeReadPairs.first.front(), barcodeReadPairs.second.front());
@@ -404,7 +431,7 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 		if("all" != barcodeName && ids.containsMids() && ids.mDeterminator_->mids_.at(barcodeName).forSameAsRev_){
 			primerCheckComplement = true;
 		}
-		while(barcodePairsReader.readNextRead(seq)){
+		while(timer.time(readParsingStage, barcodeGroup, [&barcodePairsReader,&seq](){ return barcodePairsReader.readNextRead(seq);})){
 			//std::cout << barcodeCount << std::endl;
 			if (setUp.pars_.verbose_) {
 				pbar.outputProgAdd(std::cout, 1, true);
@@ -414,6 +441,7 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 			//forward
 			std::string forwardPrimerName = "";
 			bool foundInReverse = false;
+			StageTimer::Lap primerLap(timer, primerSearchStage, barcodeGroup);
 			if(pars.corePars_.noPrimers_){
 				forwardPrimerName = ids.pDeterminator_->primers_.begin()->first;
 			}else{
@@ -445,6 +473,8 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 
 
 
+			primerLap.stop();
+
 			std::string fullname = "";
 			if(forwardPrimerName != reversePrimerName){
 				fullname = forwardPrimerName + "-" + reversePrimerName;
@@ -462,12 +492,14 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 				 "unrecognized" == reversePrimerName){
 				//check for unrecognized primers
 				stats.increaseFailedForward(barcodeName, seq.seqBase_.name_);
-				midReaderOuts.openWrite("unrecognized", seq);
+				timedWrite("unrecognized");
 				//++allPrimerCounts[fullname];
 				++unrecognizedPrimers;
 				seq.mateSeqBase_.reverseComplementRead(false, true);
 				seq.mateRComplemented_ = true;
-				auto mismatchedPairRes = pairProcessor.processPairedEnd(seq, mismatchedPrimerPairProcessCounts, processingPairsAligner);
+				auto mismatchedPairRes = timer.time(stitchingStage, barcodeGroup, [&pairProcessor,&seq,&mismatchedPrimerPairProcessCounts,&processingPairsAligner](){
+					return pairProcessor.processPairedEnd(seq, mismatchedPrimerPairProcessCounts, processingPairsAligner);
+				});
 				if(mismatchedPairRes.status_ != PairedReadProcessor::ReadPairOverLapStatus::NONE &&
 						mismatchedPairRes.status_ != PairedReadProcessor::ReadPairOverLapStatus::NOOVERLAP){
 					readVec::handelLowerCaseBases(mismatchedPairRes.combinedSeq_, "remove");
@@ -486,12 +518,14 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 					if(!midReaderOuts.containsReader(fullname + "bad")){
 						midReaderOuts.addReader(fullname + "bad", badDirOutOpts);
 					}
-					midReaderOuts.openWrite(fullname + "bad", seq);
+					timedWrite(fullname + "bad");
 				}
 				//++allPrimerCounts[fullname];
 				seq.mateSeqBase_.reverseComplementRead(false, true);
 				seq.mateRComplemented_ = true;
-				auto mismatchedPairRes = pairProcessor.processPairedEnd(seq, mismatchedPrimerPairProcessCounts, processingPairsAligner);
+				auto mismatchedPairRes = timer.time(stitchingStage, barcodeGroup, [&pairProcessor,&seq,&mismatchedPrimerPairProcessCounts,&processingPairsAligner](){
+					return pairProcessor.processPairedEnd(seq, mismatchedPrimerPairProcessCounts, processingPairsAligner);
+				});
 				if(mismatchedPairRes.status_ != PairedReadProcessor::ReadPairOverLapStatus::NONE &&
 						mismatchedPairRes.status_ != PairedReadProcessor::ReadPairOverLapStatus::NOOVERLAP){
 					readVec::handelLowerCaseBases(mismatchedPairRes.combinedSeq_, "remove");
@@ -518,11 +552,12 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 				}
 				stats.increaseCounts(fullname, seq.seqBase_.name_,
 						ExtractionStator::extractCase::GOOD);
-				midReaderOuts.openWrite(fullname + "good", seq);
+				timedWrite(fullname + "good");
 				++allPrimerCounts[fullname];
 				++matchingPrimerCounts[fullname];
 			}
 		}
+		timer.time(writingStage, barcodeGroup, [&midReaderOuts](){ midReaderOuts.closeOutAll();}, true);
 	}
 
 //	{
@@ -570,6 +605,7 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 	for(const auto & extractedMid : primersInMids){
 		for(const auto & extractedPrimer : extractedMid.second){
 			std::string name = extractedPrimer + extractedMid.first;
+			const auto nameGroup = timer.getGroupId(name);
 			if(!ids.containsMids() && "" != pars.corePars_.sampleName){
 				name = extractedPrimer + pars.corePars_.sampleName;
 			}else if(!ids.containsMids() && "all" == extractedMid.first){
@@ -671,7 +707,10 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 			if(setUp.pars_.verbose_){
 				std::cout << "Pair Processing " << name << std::endl;
 			}
+			StageTimer::Lap stitchLap(timer, stitchingStage, nameGroup, 1, true);
 			auto currentProcessResults = pairProcessor.processPairedEnd(currentReader, processWriter, processingPairsAligner);
+			stitchLap.setReads(currentProcessResults.total);
+			stitchLap.stop();
 			if(setUp.pars_.verbose_){
 				std::cout << "Done Pair Processing for " << name << std::endl;
 			}
@@ -757,6 +796,7 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 	for(const auto & extractedMid : primersInMids){
 		for(const auto & extractedPrimer : extractedMid.second){
 			std::string name = extractedPrimer + extractedMid.first;
+			const auto nameGroup = timer.getGroupId(name);
 			if(!ids.containsMids() && "" != pars.corePars_.sampleName){
 				name = extractedPrimer + pars.corePars_.sampleName;
 			}else if(!ids.containsMids() && "all" == extractedMid.first){
@@ -798,9 +838,10 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 				tempWriter.openOut();
 				tempOuts[name] = SeqIOOptions::genPairedIn(tempWriter.getPrimaryOutFnp(),
 						tempWriter.getSecondaryOutFnp());
-				while(processedReader.readNextRead(filteringSeq)
+				while(timer.time(readParsingStage, nameGroup, [&processedReader,&filteringSeq](){ return processedReader.readNextRead(filteringSeq);})
 						|| filteringSeq.seqBase_.seq_.size() <= pars.corePars_.primIdsPars.compKmerLen_
 						|| filteringSeq.mateSeqBase_.seq_.size() <= pars.corePars_.primIdsPars.compKmerLen_){
+					StageTimer::Lap contamLap(timer, contamScreeningStage, nameGroup);
 					bool pass = false;
 					if(pairProcessor.params_.r1Trim_ > 0 && pairProcessor.params_.r1Trim_ < len(filteringSeq.seqBase_)){
 						readVecTrimmer::trimOffEndBases(filteringSeq.seqBase_, pairProcessor.params_.r1Trim_);
@@ -816,8 +857,8 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 						auto secodnMateCopy = filteringSeq.mateSeqBase_;
 						seqUtil::removeLowerCase(firstMateCopy.seq_,firstMateCopy.qual_);
 						seqUtil::removeLowerCase(secodnMateCopy.seq_,secodnMateCopy.qual_);
-						kmerInfo seqKInfo(firstMateCopy.seq_, pars.corePars_.primIdsPars.compKmerLen_, false);
-						kmerInfo mateSeqInfo(secodnMateCopy.seq_, pars.corePars_.primIdsPars.compKmerLen_, true);
+						PackedKmerSet seqKInfo(firstMateCopy.seq_, pars.corePars_.primIdsPars.compKmerLen_, false);
+						PackedKmerSet mateSeqInfo(secodnMateCopy.seq_, pars.corePars_.primIdsPars.compKmerLen_, true);
 
 						for(const auto & refKinfo : ids.targets_.at(extractedPrimer).refKInfos_){
 							if(refKinfo.compareKmers(seqKInfo).second >= pars.corePars_.primIdsPars.compKmerSimCutOff_ &&
@@ -827,6 +868,8 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 							}
 						}
 					}
+					contamLap.stop();
+					StageTimer::Lap writeLap(timer, writingStage, nameGroup);
 					if(pass){
 						tempWriter.write(filteringSeq);
 					}else{
@@ -899,12 +942,13 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 					SeqInput processedReader(filterSeqOpts);
 					processedReader.openIn();
 
-					while(processedReader.readNextRead(filteringSeq)){
+					while(timer.time(readParsingStage, nameGroup, [&processedReader,&filteringSeq](){ return processedReader.readNextRead(filteringSeq);})){
+						StageTimer::Lap contamLap(timer, contamScreeningStage, nameGroup);
 						bool pass = false;
 						if(ids.targets_.at(extractedPrimer).refs_.empty() || filteringSeq.seq_.size() <= pars.corePars_.primIdsPars.compKmerLen_){
 							pass = true;
 						}else{
-							kmerInfo seqKInfo(filteringSeq.seq_, pars.corePars_.primIdsPars.compKmerLen_, false);
+							PackedKmerSet seqKInfo(filteringSeq.seq_, pars.corePars_.primIdsPars.compKmerLen_, false);
 							for(const auto & refKinfo : ids.targets_.at(extractedPrimer).refKInfos_){
 								if(refKinfo.compareKmers(seqKInfo).second >= pars.corePars_.primIdsPars.compKmerSimCutOff_){
 									pass = true;
@@ -912,6 +956,8 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 								}
 							}
 						}
+						contamLap.stop();
+						StageTimer::Lap writeLap(timer, writingStage, nameGroup);
 						if(pass){
 							if(njh::in(extractedPrimer, lengthNeeded)){
 								readLengthsPerTarget[extractedPrimer].emplace_back(len(filteringSeq));
@@ -959,6 +1005,7 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 	for(const auto & extractedMid : primersInMids){
 		for(const auto & extractedPrimer : extractedMid.second){
 			std::string name = extractedPrimer + extractedMid.first;
+			const auto nameGroup = timer.getGroupId(name);
 			if(!ids.containsMids() && "" != pars.corePars_.sampleName){
 				name = extractedPrimer + pars.corePars_.sampleName;
 			}else if(!ids.containsMids() && "all" == extractedMid.first){
@@ -987,7 +1034,8 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 				}
 				SeqOutput finalWriter(finalSeqOut);
 				SeqOutput badWriter(badSeqOut);
-				while(tempReader.readNextRead(filteringSeq)){
+				while(timer.time(readParsingStage, nameGroup, [&tempReader,&filteringSeq](){ return tempReader.readNextRead(filteringSeq);})){
+					StageTimer::Lap qcLap(timer, qualityChecksStage, nameGroup);
 					bool bad = false;
 					if(!nChecker.checkRead(filteringSeq)){
 						++badNs[name];
@@ -995,12 +1043,14 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 					}else if(!qualChecker.checkRead(filteringSeq)){
 						++badQual[name];
 						bad = true;
-					}else{
+					}
+					qcLap.stop();
+					StageTimer::Lap writeLap(timer, writingStage, nameGroup);
+					if(!bad){
 						++used;
 						++goodFinal[name];
 						finalWriter.openWrite(filteringSeq);
-					}
-					if(bad){
+					}else{
 						++qualityFilters;
 						if(pars.corePars_.keepFilteredOff){
 							badWriter.openWrite(filteringSeq);
@@ -1027,7 +1077,8 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 				}
 				SeqOutput finalWriter(finalSeqOut);
 				SeqOutput badWriter(badSeqOUt);
-				while(tempReader.readNextRead(filteringSeq)){
+				while(timer.time(readParsingStage, nameGroup, [&tempReader,&filteringSeq](){ return tempReader.readNextRead(filteringSeq);})){
+					StageTimer::Lap qcLap(timer, qualityChecksStage, nameGroup);
 					bool bad = false;
 					if(!nChecker.checkRead(filteringSeq)){
 						bad = true;
@@ -1041,12 +1092,14 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 					}else if(!ids.targets_.at(extractedPrimer).lenCuts_->maxLenChecker_.checkRead(filteringSeq)){
 						bad = true;
 						++badMaxLen[name];
-					}else{
+					}
+					qcLap.stop();
+					StageTimer::Lap writeLap(timer, writingStage, nameGroup);
+					if(!bad){
 						++used;
 						++goodFinal[name];
 						finalWriter.openWrite(filteringSeq);
-					}
-					if(bad){
+					}else{
 						++qualityFilters;
 						if(pars.corePars_.keepFilteredOff){
 							badWriter.openWrite(filteringSeq);
@@ -1094,6 +1147,7 @@ int SeekDeepRunner::extractorPairedEnd(const njh::progutils::CmdArgs & inputComm
 				<< "\t" <<  getPercentageString(failedPairProcessingUnexpectedStatus[name], matchingPrimerCounts[name])
 				<< std::endl;
 	}
+	timer.writeJson(OutOptions(njh::files::make_path(setUp.pars_.directoryName_, "extractionTimings.json")));
 
 	auto writeOutUnrecCounts = [&seqName](const SeqIOOptions & opts, const bfs::path & outFilename){
 		if(opts.inExists()){
@@ -150,6 +150,7 @@ void SeekDeepSetUp::setUpExtractorPairedEnd(ExtractorPairedEndPars & pars) {
 	pars_.gapLeft_ = "0,0";
 	processGap();
 	if (needsHelp()) {
+		throwIfHelpInsteadOfExit();
 		printFlags(std::cout);
 		std::cout << "The id file should be tab delimited and contains the "
 				"primer and reverse primer and MIDs if the data is multiplex, "
@@ -300,6 +301,7 @@ void SeekDeepSetUp::setUpExtractor(extractorPars & pars) {
 		}
 	}
 	if (needsHelp()) {
+		throwIfHelpInsteadOfExit();
 		printFlags(std::cout);
 		std::cout << "The id file should be tab delimited and contains the "
 				"primer and reverse primer and MIDs if the data is multiplex, "
@@ -331,6 +333,27 @@ void SeekDeepSetUp::setUpExtractor(extractorPars & pars) {
 	finishSetUp(std::cout);
 }
 
+void SeekDeepSetUp::setUpExtractorBatch(ExtractorBatchPars & pars) {
+	description_ = "Run extractor or extractorPairedEnd on many inputs within one process, scheduling the inputs across a single pool of threads";
+	examples_.emplace_back("MASTERPROGRAM SUBPROGRAM --batchTable inputs.tab.txt --id idFile.tab.txt --extractorArgs \"--illumina --checkRevComplementForPrimers\" --numThreads 8");
+	examples_.emplace_back("MASTERPROGRAM SUBPROGRAM --batchTable inputs.tab.txt --id idFile.tab.txt --pairedEnd --numThreads 8");
+	processVerbose();
+	processDebug();
+	setOption(pars.batchTableFnp, "--batchTable",
+			"A tab delimited table with a header, needs columns dout and either input (for extractor) or r1 and r2 (for extractorPairedEnd), "
+			"can also have columns id (id file for that input) and extraArgs (space separated arguments added for that input only)", true, "Input");
+	setOption(pars.idFile, "--id", "The id file to use for any inputs that don't have one in the id column of --batchTable", false, "Input");
+	setOption(pars.pairedEnd, "--pairedEnd", "Run extractorPairedEnd rather than extractor", false, "Input");
+	setOption(pars.extractorArgs, "--extractorArgs", "Space separated arguments to pass to every extraction", false, "Input");
+	setOption(pars.numThreads, "--numThreads", "Number of inputs to extract at once, with more than one the extractions run without verbose output", false, "Running");
+	if(0 == pars.numThreads){
+		failed_ = true;
+		addWarning("--numThreads should be at least 1");
+	}
+	processDirectoryOutputName("extractorBatch_" + getCurrentDate(), true);
+	finishSetUp(std::cout);
+}
+
 }  // namespace njhseq
 
 
@@ -28,6 +28,8 @@
 #include <njhseq/objects/Meta/MetaUtils.hpp>
 #include <njhseq/objects/dataContainers/tables/TableReader.hpp>
 
+#include <future>
+
 namespace njhseq {
 
 
@@ -102,22 +104,92 @@ int SeekDeepRunner::processClusters(const njh::progutils::CmdArgs & inputCommand
 	if (checkingExpected) {
 		expectedSeqs = SeqInput::getReferenceSeq(setUp.pars_.refIoOptions_, maxSize);
 	}
-	// get max size for aligner
+	// get max size for aligner, qluster records it in the metaData.json next to its output so only older outputs need to be read
+	VecStr filesToScan;
 	for (const auto& sf : specificFiles) {
-		SeqIOOptions inOpts(sf, setUp.pars_.ioOptions_.inFormat_, true);
-		SeqInput reader(inOpts);
-		reader.openIn();
-		seqInfo seq;
-		while(reader.readNextRead(seq)){
-			readVec::getMaxLength(seq, maxSize);
+		auto metaDataJsonFnp = njh::files::make_path(bfs::path(sf).parent_path(), "metaData.json");
+		bool foundMaxLength = false;
+		if (bfs::exists(metaDataJsonFnp)) {
+			auto metaJson = njh::json::parseFile(metaDataJsonFnp.string());
+			if (metaJson.isMember("maxLength") && metaJson.isMember("outputFile")
+					&& bfs::path(sf).filename().string() == metaJson["outputFile"].asString()) {
+				maxSize = std::max<uint64_t>(maxSize, metaJson["maxLength"].asUInt64());
+				foundMaxLength = true;
+			}
+		}
+		if (!foundMaxLength) {
+			filesToScan.emplace_back(sf);
 		}
 	}
+	if (!filesToScan.empty()) {
+		if (setUp.pars_.verbose_) {
+			std::cout << "Reading " << filesToScan.size() << " of " << specificFiles.size()
+					<< " files for max length, the rest had it in their metaData.json" << std::endl;
+		}
+		njh::concurrent::LockableQueue<std::string> scanQueue(filesToScan);
+		std::mutex maxSizeMut;
+		std::function<void()> scanForMaxSize = [&scanQueue,&maxSizeMut,&maxSize,&setUp](){
+			uint64_t currentMaxSize = 0;
+			std::string sf = "";
+			while(scanQueue.getVal(sf)){
+				SeqIOOptions inOpts(sf, setUp.pars_.ioOptions_.inFormat_, true);
+				SeqInput reader(inOpts);
+				reader.openIn();
+				seqInfo seq;
+				while(reader.readNextRead(seq)){
+					readVec::getMaxLength(seq, currentMaxSize);
+				}
+			}
+			std::lock_guard<std::mutex> lock(maxSizeMut);
+			maxSize = std::max(maxSize, currentMaxSize);
+		};
+		njh::concurrent::runVoidFunctionThreaded(scanForMaxSize, pars.numThreads);
+	}
 	// create aligner class object
 	aligner alignerObj(maxSize, setUp.pars_.gapInfo_, setUp.pars_.scoring_,
 			KmerMaps(setUp.pars_.colOpts_.kmerOpts_.kLength_),
 			setUp.pars_.qScorePars_, setUp.pars_.colOpts_.alignOpts_.countEndGaps_,
 			setUp.pars_.colOpts_.iTOpts_.weighHomopolyer_);
 	alignerObj.processAlnInfoInput(setUp.pars_.alnInfoDirName_);
+	std::unique_ptr<AlnCacheStore> sharedAlnCache;
+	//when not otherwise writing out alignments the sample aligners dump into here so their alignments can be published
+	bfs::path sharedAlnCacheScratchDir = "";
+	if ("" != pars.sharedAlnCacheDir) {
+		setUp.rLog_.logCurrentTime("Reading in shared alignments");
+		sharedAlnCache = std::make_unique<AlnCacheStore>(pars.sharedAlnCacheDir, alignerObj);
+		//only load the alignments between the input clusters (and the expected and population sequences), the aligner pool copies
+		//this cache for each thread so loading the whole store would be multiplied by the number of threads
+		std::unordered_set<std::string> relevantSeqs;
+		for (const auto & expected : expectedSeqs) {
+			relevantSeqs.emplace(expected.seqBase_.seq_);
+		}
+		for (const auto & popSeq : globalPopSeqs) {
+			relevantSeqs.emplace(popSeq.seq_);
+		}
+		njh::concurrent::LockableQueue<std::string> relevantQueue(specificFiles);
+		std::mutex relevantSeqsMut;
+		std::function<void()> gatherRelevantSeqs = [&relevantQueue,&relevantSeqsMut,&relevantSeqs,&setUp](){
+			std::unordered_set<std::string> currentSeqs;
+			std::string sf = "";
+			while(relevantQueue.getVal(sf)){
+				SeqIOOptions inOpts(sf, setUp.pars_.ioOptions_.inFormat_, true);
+				SeqInput reader(inOpts);
+				reader.openIn();
+				seqInfo seq;
+				while(reader.readNextRead(seq)){
+					currentSeqs.emplace(seq.seq_);
+				}
+			}
+			std::lock_guard<std::mutex> lock(relevantSeqsMut);
+			relevantSeqs.insert(currentSeqs.begin(), currentSeqs.end());
+		};
+		njh::concurrent::runVoidFunctionThreaded(gatherRelevantSeqs, pars.numThreads);
+		sharedAlnCache->load(alignerObj, relevantSeqs, setUp.pars_.verbose_);
+		if ("" == setUp.pars_.outAlnInfoDirName_) {
+			sharedAlnCacheScratchDir = njh::files::make_path(setUp.pars_.directoryName_, "sharedAlnCacheScratch");
+			njh::files::makeDirP(njh::files::MkdirPar(sharedAlnCacheScratchDir.string()));
+		}
+	}
 
 
 
@@ -131,6 +203,15 @@ int SeekDeepRunner::processClusters(const njh::progutils::CmdArgs & inputCommand
 			pars.experimentNames,
 			pars.preFiltCutOffs);
 	sampColl.keepSampleInfoInMemory_ = pars.keepSampleInfoInMemory_;
+	//with a memory budget finished samples stay in memory until they would go over it
+	std::unique_ptr<SampleMemoryBudget> sampleMemBudget;
+	if (pars.maxMemory > 0) {
+		sampColl.keepSampleInfoInMemory_ = true;
+		sampleMemBudget = std::make_unique<SampleMemoryBudget>(static_cast<uint64_t>(pars.maxMemory * 1024 * 1024 * 1024));
+		//the population steps can only take every sample from memory or every sample from disk, njhseq has no way to load just the
+		//written out ones as they're needed, so once one is written out the rest are too as they finish rather than all at the end
+		sampleMemBudget->writeAllOnceOver_ = true;
+	}
 
 
 	if("" != pars.groupingsFile){
@@ -141,23 +222,81 @@ int SeekDeepRunner::processClusters(const njh::progutils::CmdArgs & inputCommand
 	std::unordered_map<std::string, double> customCutOffsMap = collapse::SampleCollapseCollection::processCustomCutOffs(pars.customCutOffs, samplesDirs, pars.fracCutoff);
 	std::unordered_map<std::string, double> customCutOffsMapPerRep = collapse::SampleCollapseCollection::processCustomCutOffs(pars.customCutOffs, samplesDirs, pars.withinReplicateFracCutOff);
 
+	//run the largest samples first so a few big samples at the end don't leave all but one thread idle
+	std::unordered_map<std::string, std::vector<bfs::path>> sampleFiles;
+	for (const auto & af : analysisFiles) {
+		auto fileToks = njh::tokenizeString(bfs::relative(af.first, pars.masterDir).string(), "/");
+		if (njh::in(fileToks[0], pars.excludeSamples)) {
+			continue;
+		}
+		sampleFiles[fileToks[0]].emplace_back(af.first);
+	}
+	//restore the samples that haven't changed since they were last stored, only the rest need to be redone
+	std::unique_ptr<SampleResultCache> sampleCache;
+	std::unordered_map<std::string, std::string> sampleCacheKeys;
+	std::set<std::string> restoredSamples;
+	if ("" != pars.sampleCacheDir) {
+		setUp.rLog_.logCurrentTime("Checking sample cache");
+		std::stringstream paramsStr;
+		//every argument that can change a sample's results, output locations, threads and caches don't
+		std::set<std::string> skipArgs{"--dout", "--overwritedir", "--numthreads", "--verbose", "--debug",
+			"--samplecachedir", "--sharedalncachedir", "--alninfodir", "--outalninfodir", "--masterdir"};
+		for (const auto & arg : setUp.commands_.arguments_) {
+			if (!njh::in(njh::strToLowerRet(arg.first), skipArgs)) {
+				paramsStr << arg.first << "=" << arg.second << "\n";
+			}
+		}
+		pars.iteratorMap.writePars(paramsStr);
+		paramsStr << AlnCacheStore::genParamsKey(alignerObj) << "\n";
+		if (checkingExpected) {
+			paramsStr << "ref=" << SampleResultCache::hashFile(setUp.pars_.refIoOptions_.firstName_) << "\n";
+		}
+		sampleCache = std::make_unique<SampleResultCache>(pars.sampleCacheDir, paramsStr.str());
+		for (auto & samp : sampleFiles) {
+			std::vector<bfs::path> relativeFiles;
+			for (const auto & fnp : samp.second) {
+				relativeFiles.emplace_back(bfs::relative(fnp, pars.masterDir));
+			}
+			sampleCacheKeys[samp.first] = sampleCache->genSampleKey(samp.first, relativeFiles, pars.masterDir,
+					njh::pasteAsStr(customCutOffsMap.at(samp.first), "\t", customCutOffsMapPerRep.at(samp.first)));
+			if (sampleCache->has(samp.first, sampleCacheKeys[samp.first])) {
+				sampleCache->restore(samp.first, sampleCacheKeys[samp.first],
+						njh::files::make_path(sampColl.masterOutputDir_, "samplesOutput", samp.first));
+				restoredSamples.emplace(samp.first);
+			}
+		}
+		setUp.rLog_ << "Restored " << restoredSamples.size() << " of " << sampleCacheKeys.size() << " samples from " << pars.sampleCacheDir << "\n";
+	}
+	SampleCostScheduler sampleScheduler(sampleFiles);
 	{
-		njh::concurrent::LockableQueue<std::string> sampleQueue(samplesDirs);
 		njhseq::concurrent::AlignerPool alnPool(alignerObj, pars.numThreads);
 		alnPool.initAligners();
 		alnPool.outAlnDir_ = setUp.pars_.outAlnInfoDirName_;
+		if ("" != sharedAlnCacheScratchDir) {
+			alnPool.outAlnDir_ = sharedAlnCacheScratchDir.string();
+		}
 
-		std::function<void()> setupClusterSamples = [&sampleQueue, &alnPool,&collapserObj,&pars,&setUp,
+		std::function<void()> setupClusterSamples = [&sampleScheduler, &alnPool,&collapserObj,&pars,&setUp,
 																&expectedSeqs,&sampColl,&customCutOffsMap,
-																&customCutOffsMapPerRep](){
+																&customCutOffsMapPerRep,&sampleCache,&sampleCacheKeys,&restoredSamples,&sampleMemBudget](){
 
 			std::string samp = "";
 			auto currentAligner = alnPool.popAligner();
-			while(sampleQueue.getVal(samp)){
+			auto threadNum = sampleScheduler.registerThread();
+			while(sampleScheduler.getNext(samp, threadNum)){
 				if(setUp.pars_.verbose_){
 					std::cout << "Starting: " << samp << std::endl;
 				}
 				sampColl.setUpSample(samp, *currentAligner, collapserObj, setUp.pars_.chiOpts_);
+				if(njh::in(samp, restoredSamples)){
+					//setting up the sample still fills in the collection's book keeping (e.g. the passing samples), the clustering
+					//comes from the results restored from the cache, which is only used when samples are written out so there's nothing to keep
+					sampColl.clearSample(samp);
+					if(setUp.pars_.verbose_){
+						std::cout << "Restored: " << samp << std::endl;
+					}
+					continue;
+				}
 
 				sampColl.clusterSample(samp, *currentAligner, collapserObj, pars.iteratorMap);
 				sampColl.sampleCollapses_.at(samp)->markChimeras(pars.chiCutOff);
@@ -203,8 +342,16 @@ int SeekDeepRunner::processClusters(const njh::progutils::CmdArgs & inputCommand
 					}
 				}
 
-				if(!sampColl.keepSampleInfoInMemory_){
+				if(nullptr != sampleMemBudget){
+					for(const auto & spillSamp : sampleMemBudget->add(samp, SampleMemoryBudget::estimateBytes(*sampColl.sampleCollapses_.at(samp)))){
+						sampColl.dumpSample(spillSamp);
+					}
+				}else if(!sampColl.keepSampleInfoInMemory_){
 					sampColl.dumpSample(samp);
+					if(nullptr != sampleCache){
+						sampleCache->store(samp, sampleCacheKeys.at(samp),
+								njh::files::make_path(sampColl.masterOutputDir_, "samplesOutput", samp));
+					}
 				}
 				if(setUp.pars_.verbose_){
 					std::cout << "Ending: " << samp << std::endl;
@@ -213,9 +360,23 @@ int SeekDeepRunner::processClusters(const njh::progutils::CmdArgs & inputCommand
 		};
 		njh::concurrent::runVoidFunctionThreaded(setupClusterSamples, pars.numThreads);
 	}
+	if (nullptr != sampleMemBudget) {
+		setUp.rLog_ << "Sample results peaked at about " << sampleMemBudget->peakBytes() / (1024.0 * 1024 * 1024)
+				<< " GB in memory, " << sampleMemBudget->spilledCount() << " samples were written out" << "\n";
+		if (sampleMemBudget->spilledCount() > 0) {
+			//every sample has been written out by now, the population steps read each back from disk one at a time as they get to it
+			sampColl.keepSampleInfoInMemory_ = false;
+		}
+	}
+	sampleScheduler.writeTimes(OutOptions(njh::files::make_path(setUp.pars_.directoryName_, "sampleProcessingTimes.tab.txt")));
+	setUp.rLog_ << "Clustered " << sampleScheduler.costs_.size() << " samples in " << sampleScheduler.wallSeconds()
+			<< " seconds with " << pars.numThreads << " threads, thread utilization " << 100 * sampleScheduler.utilization() << "%" << "\n";
 
 	//read in the dump alignment cache
 	alignerObj.processAlnInfoInput(setUp.pars_.alnInfoDirName_);
+	if ("" != sharedAlnCacheScratchDir) {
+		alignerObj.processAlnInfoInput(sharedAlnCacheScratchDir.string(), setUp.pars_.verbose_);
+	}
 
 
 	if(setUp.pars_.verbose_){
@@ -223,7 +384,58 @@ int SeekDeepRunner::processClusters(const njh::progutils::CmdArgs & inputCommand
 	}
 
 	//first population clustering
-	sampColl.doPopulationClustering(sampColl.createPopInput(), alignerObj, collapserObj, pars.popIteratorMap);
+	auto popInput = sampColl.createPopInput();
+	std::unique_ptr<CollapsePreAligner> popPreAligner;
+	if (pars.numThreads > 1 && !setUp.pars_.colOpts_.alignOpts_.noAlign_ && !pars.popIteratorMap.iters_.empty()) {
+		//the clustering itself stays serial, the candidate pairs are aligned across threads ahead of time so it only hits the cache
+		setUp.rLog_.logCurrentTime("Pre-aligning population candidates");
+		CollapsePreAligner::PreAlignPars popPreAlignPars;
+		popPreAlignPars.numThreads_ = pars.numThreads;
+		popPreAlignPars.verbose_ = setUp.pars_.verbose_;
+		popPreAlignPars.kmerLength_ = setUp.pars_.colOpts_.kmerOpts_.kLength_;
+		popPreAlignPars.candidatesPerRead_ = pars.popIteratorMap.iters_.begin()->second.stopCheck_;
+		//pairs can only be ruled out by edit distance when every error the aligner finds is counted against the iteration
+		if (!pars.onPerId
+				&& setUp.pars_.colOpts_.alignOpts_.countEndGaps_
+				&& !setUp.pars_.colOpts_.iTOpts_.weighHomopolyer_) {
+			popPreAlignPars.maxEdits_ = CollapsePreAligner::getMaxEdits(pars.popIteratorMap);
+			popPreAlignPars.iterationMaxEdits_ = CollapsePreAligner::getIterationMaxEdits(pars.popIteratorMap);
+		}
+		popPreAligner = std::make_unique<CollapsePreAligner>(popPreAlignPars);
+		auto preAlignCounts = popPreAligner->preAlign(popInput, alignerObj,
+				njh::files::make_path(setUp.pars_.directoryName_, "popPreAlignCache"));
+		setUp.rLog_ << "Pre-aligned " << preAlignCounts.aligned_ << " of " << preAlignCounts.candidates_
+				<< " population candidate pairs with " << pars.numThreads << " threads, skipped "
+				<< preAlignCounts.skippedByKmers_ << " by shared kmers and "
+				<< preAlignCounts.skippedByEdits_ << " by banded edit distance" << "\n";
+	}
+	//the pairs ruled out by pre-aligning were ruled out against the population input sequences, with --debug the population clustering is
+	//first run without them on a copy so the clustering kept below can be checked against it
+	const bool checkPopEquivalence = setUp.pars_.debug_ && nullptr != popPreAligner && CollapsePreAligner::hasAddedChecks(popInput);
+	std::vector<sampleCluster> unfilteredPopClusters;
+	if (checkPopEquivalence) {
+		auto unfilteredPopInput = CollapsePreAligner::copyWithoutAddedChecks(popInput);
+		sampColl.doPopulationClustering(unfilteredPopInput, alignerObj, collapserObj, pars.popIteratorMap);
+		unfilteredPopClusters = sampColl.popCollapse_->collapsed_.clusters_;
+	}
+	sampColl.doPopulationClustering(popInput, alignerObj, collapserObj, pars.popIteratorMap);
+	if (checkPopEquivalence) {
+		std::stringstream clusterDiffs;
+		if (!CollapsePreAligner::sameClusters(unfilteredPopClusters, sampColl.popCollapse_->collapsed_.clusters_, clusterDiffs)) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error population clustering with the pre-align checks differs from clustering without them" << "\n";
+			ss << clusterDiffs.str();
+			throw std::runtime_error{ss.str()};
+		}
+		setUp.rLog_ << "Population clustering with the pre-align checks matched clustering without them" << "\n";
+	}
+	if (nullptr != popPreAligner) {
+		//the failing checks added for pairs too far apart only hold for the population iterations, the rescue and filtering steps below
+		//re-cluster with the population clusters and need to compare those pairs for real
+		auto removedChecks = popPreAligner->removeAddedChecks(sampColl.popCollapse_->input_.clusters_);
+		removedChecks += popPreAligner->removeAddedChecks(sampColl.popCollapse_->collapsed_.clusters_);
+		setUp.rLog_ << "Removed " << removedChecks << " pre-align checks from the population clusters" << "\n";
+	}
 
 
 	if(pars.rescuePars_.performResuce()){
@@ -244,16 +456,13 @@ int SeekDeepRunner::processClusters(const njh::progutils::CmdArgs & inputCommand
 		//collapse indentical seqs
 		std::vector<readObject> previousPopSeqs;
 		std::vector<std::set<std::string>> allNamesForPreviousPops;
+		std::unordered_map<std::string, uint32_t> previousPopSeqPositions;
 		for(const auto & seq : previousPopSeqsRaw){
-			bool matchPrevious = false;
-			for(const auto  other : iter::enumerate(previousPopSeqs)){
-				if(other.element.seqBase_.seq_ == seq.seqBase_.seq_){
-					matchPrevious = true;
-					allNamesForPreviousPops[other.first].emplace(seq.seqBase_.name_);
-					break;
-				}
-			}
-			if(!matchPrevious){
+			auto search = previousPopSeqPositions.find(seq.seqBase_.seq_);
+			if(previousPopSeqPositions.end() != search){
+				allNamesForPreviousPops[search->second].emplace(seq.seqBase_.name_);
+			}else{
+				previousPopSeqPositions.emplace(seq.seqBase_.seq_, previousPopSeqs.size());
 				previousPopSeqs.emplace_back(seq);
 				allNamesForPreviousPops.emplace_back(std::set<std::string>{seq.seqBase_.name_});
 			}
@@ -264,6 +473,53 @@ int SeekDeepRunner::processClusters(const njh::progutils::CmdArgs & inputCommand
 				other.element.seqBase_.name_ = njh::conToStr(allNamesForPreviousPops[other.index], ":");
 			}
 		}
+		//only previous sequences that could be within the allowed errors of a population haplotype need to be aligned to,
+		//the rest are left out before renaming, which keeps the same order so the same names are picked
+		uint32_t previousPopMaxEdits = CollapsePreAligner::getMaxEdits(pars.previousPopErrors);
+		if(std::numeric_limits<uint32_t>::max() != previousPopMaxEdits && !previousPopSeqs.empty()){
+			uint32_t catalogKLen = pars.previousPopKLength;
+			if(0 == catalogKLen){
+				//by the pigeonhole principle a sequence within e edits shares an exact stretch of at least length / (e + 1) bases, half
+				//of that leaves room for several shared kmers, capped so short or very different sequences still get a useful length
+				uint64_t shortestLen = std::numeric_limits<uint64_t>::max();
+				for(const auto & seq : previousPopSeqs){
+					shortestLen = std::min<uint64_t>(shortestLen, seq.seqBase_.seq_.size());
+				}
+				for(const auto & clus : sampColl.popCollapse_->collapsed_.clusters_){
+					shortestLen = std::min<uint64_t>(shortestLen, clus.seqBase_.seq_.size());
+				}
+				catalogKLen = static_cast<uint32_t>(std::min<uint64_t>(16, std::max<uint64_t>(4, shortestLen / (2 * (static_cast<uint64_t>(previousPopMaxEdits) + 1)))));
+			}
+			VecStr previousSeqs;
+			for(const auto & seq : previousPopSeqs){
+				previousSeqs.emplace_back(seq.seqBase_.seq_);
+			}
+			SeqCatalogIndex previousPopIndex(previousSeqs, catalogKLen);
+			std::vector<bool> keepPrevious(previousPopSeqs.size(), false);
+			uint32_t exactMatches = 0;
+			for(const auto & clus : sampColl.popCollapse_->collapsed_.clusters_){
+				//an identical previous sequence is the best match a haplotype can have, so its near matches don't need to be kept for it
+				auto exactPos = previousPopIndex.getExactMatch(clus.seqBase_.seq_);
+				if(exactPos >= 0){
+					++exactMatches;
+					keepPrevious[exactPos] = true;
+					continue;
+				}
+				for(const auto pos : previousPopIndex.getCandidates(clus.seqBase_.seq_, previousPopMaxEdits)){
+					keepPrevious[pos] = true;
+				}
+			}
+			std::vector<readObject> previousPopCandidates;
+			for(const auto pos : iter::range(previousPopSeqs.size())){
+				if(keepPrevious[pos]){
+					previousPopCandidates.emplace_back(previousPopSeqs[pos]);
+				}
+			}
+			setUp.rLog_ << "Renaming against " << previousPopCandidates.size() << " of " << previousPopSeqs.size()
+					<< " previous population sequences found with " << catalogKLen << "-mers, " << exactMatches << " of " << sampColl.popCollapse_->collapsed_.clusters_.size()
+					<< " haplotypes have an exact match" << "\n";
+			previousPopSeqs = previousPopCandidates;
+		}
 		sampColl.renamePopWithSeqs(previousPopSeqs, pars.previousPopErrors);
 	}
 
@@ -273,6 +529,13 @@ int SeekDeepRunner::processClusters(const njh::progutils::CmdArgs & inputCommand
 
   alignerObj.processAlnInfoOutput(setUp.pars_.outAlnInfoDirName_,
                                   setUp.pars_.verbose_);
+	if (nullptr != sharedAlnCache) {
+		setUp.rLog_.logCurrentTime("Publishing shared alignments");
+		sharedAlnCache->publish(alignerObj, setUp.pars_.verbose_);
+		if ("" != sharedAlnCacheScratchDir) {
+			njh::files::rmDirForce(sharedAlnCacheScratchDir);
+		}
+	}
   setUp.rLog_ << alignerObj.numberOfAlingmentsDone_ << "\n";
   if (setUp.pars_.verbose_) {
     std::cout << alignerObj.numberOfAlingmentsDone_ << std::endl;
@@ -688,21 +951,105 @@ int SeekDeepRunner::processClusters(const njh::progutils::CmdArgs & inputCommand
 //    std::cout << njh::conToStr(njh::getVecOfMapKeys(fullAATyped), ",") << std::endl;
 		clus.meta_.addMeta("h_AATyped", typed);
 	}
-	sampColl.printSampleCollapseInfo(
-			njh::files::make_path(sampColl.masterOutputDir_,
-					"selectedClustersInfo.tab.txt.gz"));
-
+	//with more than one thread the big info tables are gzipped in the background while the rest of the output is written. njhseq only
+	//writes the cluster info tables to a file name, so they're written plain first and compressed after, which is a second pass over
+	//them and leaves the plain copies behind if the run is killed. With one thread there's nothing to overlap so njhseq gzips them itself.
+	//The group info files are written by createGroupInfoFiles() inside njhseq and keep its gzip
+	const bool gzipInBackground = pars.numThreads > 1;
+	ParallelGzipWriter::Pars gzPars;
+	//one fewer compressing thread than --numThreads since the main thread keeps writing output while they run
+	std::shared_ptr<ParallelGzipWriter::CompressPool> gzPool;
+	if (gzipInBackground) {
+		gzPool = std::make_shared<ParallelGzipWriter::CompressPool>(pars.numThreads - 1);
+	}
+	//run one after another on a single background thread, each one compresses across the whole pool
+	std::vector<std::function<void()>> gzJobs;
+	auto writeGzipped = [&gzipInBackground,&gzJobs,&gzPars,&gzPool](const bfs::path & plainFnp, const bfs::path & gzFnp,
+			const std::function<void(const bfs::path &)> & writeTo){
+		if(!gzipInBackground){
+			writeTo(gzFnp);
+			return;
+		}
+		try {
+			writeTo(plainFnp);
+		} catch (...) {
+			if(bfs::exists(plainFnp)){
+				bfs::remove(plainFnp);
+			}
+			throw;
+		}
+		gzJobs.emplace_back([plainFnp,gzFnp,&gzPars,&gzPool](){
+			OutOptions gzOpts(gzFnp);
+			gzOpts.overWriteFile_ = true;
+			try {
+				ParallelGzipWriter::compressFile(plainFnp, gzOpts, gzPars, gzPool);
+			} catch (...) {
+				bfs::remove(plainFnp);
+				if(bfs::exists(gzFnp)){
+					bfs::remove(gzFnp);
+				}
+				throw;
+			}
+			bfs::remove(plainFnp);
+		});
+	};
+	writeGzipped(njh::files::make_path(sampColl.masterOutputDir_, "selectedClustersInfo_uncompressed.tab.txt"),
+			njh::files::make_path(sampColl.masterOutputDir_, "selectedClustersInfo.tab.txt.gz"),
+			[&sampColl](const bfs::path & fnp){
+		sampColl.printSampleCollapseInfo(fnp);
+	});
 	if(pars.writeOutAllInfoFile){
-		sampColl.printAllSubClusterInfo(
-					njh::files::make_path(sampColl.masterOutputDir_,
-							"allClustersInfo.tab.txt.gz"));
+		writeGzipped(njh::files::make_path(sampColl.masterOutputDir_, "allClustersInfo_uncompressed.tab.txt"),
+				njh::files::make_path(sampColl.masterOutputDir_, "allClustersInfo.tab.txt.gz"),
+				[&sampColl](const bfs::path & fnp){
+			sampColl.printAllSubClusterInfo(fnp);
+		});
 	}
 	sampColl.symlinkInSampleFinals();
 	sampColl.outputRepAgreementInfo();
 
-	table hapIdTab = sampColl.genHapIdTable();
-	hapIdTab.outPutContents(TableIOOpts::genTabFileOut(njh::files::make_path(sampColl.masterOutputDir_,
-			"hapIdTable.tab.txt.gz"), true));
+	{
+		auto hapIdTab = std::make_shared<table>(sampColl.genHapIdTable());
+		auto hapIdFnp = njh::files::make_path(sampColl.masterOutputDir_, "hapIdTable.tab.txt.gz");
+		if(gzipInBackground){
+			//the table is already in memory so it's streamed straight into the gzip writer
+			gzJobs.emplace_back([hapIdTab,hapIdFnp,&gzPars,&gzPool](){
+				OutOptions gzOpts(hapIdFnp);
+				gzOpts.overWriteFile_ = true;
+				try {
+					ParallelGzipWriter hapIdOut(gzOpts, gzPars, gzPool);
+					hapIdTab->outPutContents(hapIdOut, "\t");
+					hapIdOut.finish();
+				} catch (...) {
+					if(bfs::exists(hapIdFnp)){
+						bfs::remove(hapIdFnp);
+					}
+					throw;
+				}
+			});
+		}else{
+			hapIdTab->outPutContents(TableIOOpts::genTabFileOut(hapIdFnp, true));
+		}
+	}
+	std::future<void> pendingGzips;
+	if(!gzJobs.empty()){
+		pendingGzips = std::async(std::launch::async, [gzJobs](){
+			//every job is run so each cleans up after itself, the first error is thrown once they're done
+			std::exception_ptr firstError;
+			for(const auto & job : gzJobs){
+				try {
+					job();
+				} catch (...) {
+					if(nullptr == firstError){
+						firstError = std::current_exception();
+					}
+				}
+			}
+			if(nullptr != firstError){
+				std::rethrow_exception(firstError);
+			}
+		});
+	}
 	sampColl.dumpPopulation();
   auto outPopSeqsPerSampIoOpts = SeqIOOptions(njh::files::make_path(sampColl.masterOutputDir_, "population", "popSeqsWithMetaWtihSampleName"), setUp.pars_.ioOptions_.outFormat_);
   SeqOutput::write(outPopSeqsPerSamp,outPopSeqsPerSampIoOpts);
@@ -748,59 +1095,27 @@ int SeekDeepRunner::processClusters(const njh::progutils::CmdArgs & inputCommand
 		std::cout << "Extraction Dirs" << std::endl;
 		std::cout << njh::conToStr(extractionDirs, "\n") << std::endl;
 	}
-	table profileTab;
-	table statsTab;
+	//the concatenating below reads with --numThreads threads, so the compressing is finished first rather than running alongside it
+	if(pendingGzips.valid()){
+		pendingGzips.get();
+	}
+	//concatenate the per directory extraction info, rows are streamed straight to the output in extractionDir order
+	StreamingTableConcatenator profileConcatenator("extractionDir");
+	StreamingTableConcatenator statsConcatenator("extractionDir");
 	for(const auto & extractDir : extractionDirs){
-		auto profileFnp = njh::files::make_path(extractDir, "extractionProfile.tab.txt");
-		auto statsFnp = njh::files::make_path(extractDir, "extractionStats.tab.txt");
-		if(bfs::exists(profileFnp)){
-			table currentProfileTab(profileFnp.string(), "\t", true);
-			auto oldColumnNames = currentProfileTab.columnNames_;
-			currentProfileTab.addColumn(VecStr{extractDir.filename().string()}, "extractionDir");
-			currentProfileTab = currentProfileTab.getColumns(concatVecs(VecStr{"extractionDir"}, oldColumnNames));
-			if(profileTab.empty()){
-				profileTab = currentProfileTab;
-			}else{
-				profileTab.rbind(currentProfileTab, false);
-			}
-		}
-		if(bfs::exists(statsFnp)){
-			table curentStatsTab(statsFnp.string(), "\t", true);
-			auto oldColumnNames = curentStatsTab.columnNames_;
-			curentStatsTab.addColumn(VecStr{extractDir.filename().string()}, "extractionDir");
-			curentStatsTab = curentStatsTab.getColumns(concatVecs(VecStr{"extractionDir"}, oldColumnNames));
-			if(statsTab.empty()){
-				statsTab = curentStatsTab;
-			}else{
-				statsTab.rbind(curentStatsTab, false);
-			}
-		}
+		profileConcatenator.addInput(extractDir.filename().string(), njh::files::make_path(extractDir, "extractionProfile.tab.txt"));
+		statsConcatenator.addInput(extractDir.filename().string(), njh::files::make_path(extractDir, "extractionStats.tab.txt"));
 	}
 
 	auto extractionOutputDir = njh::files::make_path(setUp.pars_.directoryName_,
 			"extractionInfo");
 	njh::files::makeDirP(njh::files::MkdirPar(extractionOutputDir.string()));
-	if (!profileTab.empty()) {
-		profileTab.sortTable("extractionDir", false);
-		auto profileTabOpts =
-				TableIOOpts::genTabFileOut(
-						njh::files::make_path(extractionOutputDir,
-								"extractionProfile.tab.txt").string(), true);
-		profileTabOpts.out_.overWriteFile_ = true;
-		profileTab.outPutContents(profileTabOpts);
-	}
-	if (!statsTab.empty()) {
-		auto statsTabOpts =
-				TableIOOpts::genTabFileOut(
-						njh::files::make_path(extractionOutputDir,
-								"extractionStats.tab.txt").string(), true);
-		statsTabOpts.out_.overWriteFile_ = true;
-		statsTab.sortTable("extractionDir", false);
-		statsTab.outPutContents(statsTabOpts);
-	}
-
-
-
+	OutOptions profileOutOpts(njh::files::make_path(extractionOutputDir, "extractionProfile.tab.txt"));
+	profileOutOpts.overWriteFile_ = true;
+	profileConcatenator.writeOut(profileOutOpts, pars.numThreads);
+	OutOptions statsOutOpts(njh::files::make_path(extractionOutputDir, "extractionStats.tab.txt"));
+	statsOutOpts.overWriteFile_ = true;
+	statsConcatenator.writeOut(statsOutOpts, pars.numThreads);
 
 	return 0;
 }
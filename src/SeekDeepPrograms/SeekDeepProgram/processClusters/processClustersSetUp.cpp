@@ -90,6 +90,11 @@ void SeekDeepSetUp::setUpMultipleSampleCluster(processClustersPars & pars) {
 			"Two Column Table, first column is sample name, second is a custom frac cut off, if sample not found will default to --fracCutOff", false, "Filtering");
 	setOption(pars.previousPopFilename, "--previousPop", "previousPopFilename", false, "Population");
 	processComparison(pars.previousPopErrors, "previousPop");
+	setOption(pars.previousPopKLength, "--previousPopKLength", "Kmer length used to find the previous population sequences that could be within the allowed errors of a haplotype, 0 to pick it from the allowed errors and sequence lengths", false, "Population");
+	if (pars.previousPopKLength > 32) {
+		failed_ = true;
+		addWarning("--previousPopKLength can't be more than 32");
+	}
 	setOption(pars.groupingsFile, "--groupingsFile",
 			"A file to sort samples into different groups", false, "Meta");
 	setOption(pars.noWriteGroupInfoFiles, "--noWriteGroupInfoFiles",
@@ -221,6 +226,25 @@ void SeekDeepSetUp::setUpMultipleSampleCluster(processClustersPars & pars) {
 	setOption(pars_.chiOpts_.parentFreqs_, "--parFreqs", "Chimeric Parent Frequency multiplier cutoff", false, "Chimeras");
 
 	setOption(pars.numThreads, "--numThreads", "Number of threads to use");
+	setOption(pars.sampleCacheDir, "--sampleCacheDir", "A directory to store each sample's results in, samples whose clustered input and parameters haven't changed since they were stored are restored rather than redone, population clustering is always redone", false, "Running");
+	if ("" != pars.sampleCacheDir && pars.keepSampleInfoInMemory_) {
+		failed_ = true;
+		addWarning("--sampleCacheDir can't be used with --keepSamplesInfoInMemory, samples have to be written out to be stored");
+	}
+	setOption(pars.maxMemory, "--maxMemory", "Keep finished samples in memory rather than writing them out, up to about this many gigabytes, once over every sample is written out since the population steps need either all samples in memory or all on disk, 0 to always write them out", false, "Running");
+	if (pars.maxMemory < 0) {
+		failed_ = true;
+		addWarning("--maxMemory can't be negative");
+	}
+	if (pars.maxMemory > 0 && pars.keepSampleInfoInMemory_) {
+		failed_ = true;
+		addWarning("--maxMemory can't be used with --keepSamplesInfoInMemory, use one or the other");
+	}
+	if (pars.maxMemory > 0 && "" != pars.sampleCacheDir) {
+		failed_ = true;
+		addWarning("--maxMemory can't be used with --sampleCacheDir, samples have to be written out to be stored");
+	}
+	setOption(pars.sharedAlnCacheDir, "--sharedAlnCacheDir", "A directory of alignments to load and add to, can be shared by many qluster and processClusters runs (even at the same time), alignments are only shared between runs with the same alignment parameters", false, "Alignment");
 
   pars.collapseVarCallPars.calcPopMeasuresPars.numThreads = pars.numThreads;
 	setOption(pars.writeOutAllInfoFile, "--writeOutAllInfoFile", "Write Out All Info File that contains information on all clusters including excluded ones");